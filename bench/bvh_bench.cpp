@@ -0,0 +1,97 @@
+// BVH 基准：10 万个包围盒的构建、refit、重建与查询耗时
+#include <scene/bvh.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main() {
+    const int count = 100000;
+    const float worldSize = 500.0f;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-worldSize, worldSize);
+    std::uniform_real_distribution<float> size(0.2f, 2.0f);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+
+    std::vector<AABB> boxes(count);
+    for (auto& box : boxes) {
+        glm::vec3 center(position(rng), position(rng) * 0.2f, position(rng));
+        glm::vec3 half(size(rng));
+        box = AABB(center - half, center + half);
+    }
+
+    DynamicBVH bvh;
+    std::vector<int> proxies(count);
+
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        proxies[i] = bvh.insert(boxes[i], &boxes[i]);
+    }
+    std::printf("%-28s %10.2f ms  (height %d, cost %.1f)\n", "incremental insert (SAH)", elapsedMs(start),
+                bvh.getHeight(), bvh.getCost());
+
+    start = Clock::now();
+    bvh.rebuild();
+    std::printf("%-28s %10.2f ms  (height %d, cost %.1f)\n", "full rebuild (binned SAH)", elapsedMs(start),
+                bvh.getHeight(), bvh.getCost());
+
+    // 移动一部分物体，只做 refit
+    for (int fraction : { 10, 100 }) {
+        int moved = count * fraction / 100;
+        start = Clock::now();
+        for (int i = 0; i < moved; ++i) {
+            glm::vec3 offset(jitter(rng), 0.0f, jitter(rng));
+            boxes[i] = AABB(boxes[i].min + offset, boxes[i].max + offset);
+            bvh.update(proxies[i], boxes[i]);
+        }
+        char label[64];
+        std::snprintf(label, sizeof(label), "refit %d%% moved", fraction);
+        std::printf("%-28s %10.2f ms  (cost %.1f)\n", label, elapsedMs(start), bvh.getCost());
+    }
+
+    // 视锥体查询：BVH 与线性扫描对比
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, 0.0f), glm::vec3(100.0f, 0.0f, 100.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum(projection * view);
+
+    const int queries = 20;
+    std::vector<void*> visible;
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        visible.clear();
+        bvh.queryFrustum(frustum, visible);
+    }
+    std::printf("%-28s %10.3f ms  (%zu visible)\n", "frustum query (BVH)", elapsedMs(start) / queries, visible.size());
+
+    size_t linearVisible = 0;
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        linearVisible = 0;
+        for (const auto& box : boxes) linearVisible += frustum.testAABB(box) ? 1 : 0;
+    }
+    std::printf("%-28s %10.3f ms  (%zu visible)\n", "frustum query (linear)", elapsedMs(start) / queries, linearVisible);
+
+    // 射线查询
+    const int rays = 10000;
+    int hits = 0;
+    start = Clock::now();
+    for (int r = 0; r < rays; ++r) {
+        Ray ray{ glm::vec3(position(rng), 50.0f, position(rng)), glm::vec3(jitter(rng), -1.0f, jitter(rng)) };
+        if (bvh.raycast(ray, 1000.0f)) ++hits;
+    }
+    std::printf("%-28s %10.4f ms  (%d / %d hit)\n", "raycast", elapsedMs(start) / rays, hits, rays);
+
+    start = Clock::now();
+    bool rebuilt = bvh.rebuildIfDegraded(1.2f);
+    std::printf("%-28s %10.2f ms  (rebuilt: %s, cost %.1f)\n", "rebuildIfDegraded(1.2)", elapsedMs(start),
+                rebuilt ? "yes" : "no", bvh.getCost());
+    return 0;
+}
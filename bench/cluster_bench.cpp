@@ -0,0 +1,53 @@
+// 分簇光照基准：测量不同光源数量与线程数下 LightClusterer::assign 的耗时
+#include <light/light_cluster.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+static std::vector<glm::vec4> makeLights(size_t count, float nearPlane, float farPlane, float radius) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> depth(nearPlane, farPlane * 0.5f);
+
+    // 光源分布在视锥体内
+    std::vector<glm::vec4> lights(count);
+    for (auto& light : lights) {
+        float z = depth(rng);
+        light = glm::vec4(unit(rng) * z, unit(rng) * z * 0.6f, -z, radius);
+    }
+    return lights;
+}
+
+int main() {
+    const float fovY = 0.7854f, aspect = 16.0f / 9.0f, nearPlane = 0.1f, farPlane = 100.0f;
+    const int iterations = 50;
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    LightClusterer clusterer;
+    clusterer.setProjection(fovY, aspect, nearPlane, farPlane);
+    std::printf("clusters: %dx%dx%d, hardware threads: %u\n",
+                clusterer.getTilesX(), clusterer.getTilesY(), clusterer.getSlicesZ(), hardwareThreads);
+    std::printf("%8s %8s %12s %14s\n", "lights", "threads", "ms/assign", "indices");
+
+    for (size_t count : { 16, 128, 1024, 4096 }) {
+        // 较强衰减的小范围光源（常数 1，一次 0.7，二次 1.8）
+        float radius = computeLightRange(1.0f, 0.7f, 1.8f, 1.0f);
+        std::vector<glm::vec4> lights = makeLights(count, nearPlane, farPlane, radius);
+
+        for (unsigned threads : { 1u, hardwareThreads }) {
+            clusterer.assign(lights, threads); // 预热
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                clusterer.assign(lights, threads);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+            std::printf("%8zu %8u %12.3f %14zu\n", count, threads, ms, clusterer.getLightIndices().size());
+            if (hardwareThreads == 1) break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// 遮挡剔除基准：遮挡体光栅化（单线程 / 多线程）、Hi-Z 构建与包围盒测试
+#include <scene/occlusion.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main() {
+    // 单位立方体（与 Cube::getOccluderGeometry 一致）
+    std::vector<glm::vec3> cubeVertices;
+    for (int i = 0; i < 8; ++i) {
+        cubeVertices.push_back(glm::vec3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f));
+    }
+    std::vector<uint32_t> cubeIndices = {
+        0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6,  0, 1, 5, 0, 5, 4,
+        2, 6, 7, 2, 7, 3,  0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5
+    };
+
+    // 室内场景：一排排墙壁作为遮挡体，墙后散布大量小物体
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::mat4> walls;
+    for (int row = 0; row < 10; ++row) {
+        for (int col = 0; col < 20; ++col) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(-40.0f + col * 4.0f, 2.0f, -5.0f - row * 8.0f));
+            walls.push_back(glm::scale(model, glm::vec3(3.8f, 4.0f, 0.3f)));
+        }
+    }
+    const int objectCount = 100000;
+    std::vector<AABB> objects(objectCount);
+    for (auto& box : objects) {
+        glm::vec3 center(-40.0f + unit(rng) * 80.0f, unit(rng) * 4.0f, -6.0f - unit(rng) * 80.0f);
+        box = AABB(center - glm::vec3(0.25f), center + glm::vec3(0.25f));
+    }
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 5.0f), glm::vec3(0.0f, 2.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const int iterations = 50;
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    OcclusionCuller culler(256, 128);
+    for (unsigned threads : { 1u, hardwareThreads }) {
+        culler.setThreadCount(threads);
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            culler.beginFrame(projection * view);
+            for (const auto& model : walls) culler.addOccluder(cubeVertices, cubeIndices, model);
+            culler.rasterize();
+        }
+        std::printf("setup + rasterize (%2u threads) %8.3f ms  (%zu triangles)\n",
+                    threads, elapsedMs(start) / iterations, culler.getTriangleCount());
+        if (hardwareThreads == 1) break;
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) culler.buildHiZ();
+    std::printf("build Hi-Z                   %8.3f ms  (%d levels)\n", elapsedMs(start) / iterations, culler.getMipCount());
+
+    int visible = 0;
+    start = Clock::now();
+    for (const auto& box : objects) visible += culler.isVisible(box) ? 1 : 0;
+    double testMs = elapsedMs(start);
+    std::printf("test %d boxes            %8.3f ms  (%d visible, %d occluded)\n",
+                objectCount, testMs, visible, objectCount - visible);
+    return 0;
+}
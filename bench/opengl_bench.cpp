@@ -0,0 +1,276 @@
+// 渲染帧时间基准：参数化场景 + 固定的摄像机路径，输出 CPU / GPU 帧时间分布（JSON）
+//
+// 默认以无显示模式运行，同一台机器上不同提交的结果可以直接比较：
+//   opengl_bench --cubes 2000 --spheres 2000 --lights 64 --frames 600 --out result.json
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glwindow.hpp"
+#include "shapes.hpp"
+#include "shader.hpp"
+#include "camera.hpp"
+#include "light.hpp"
+#include "profiler.hpp"
+
+struct BenchConfig {
+    int cubes = 1000;
+    int spheres = 1000;
+    int lights = 32;
+    int frames = 600;
+    int warmup = 60;            // 不计入统计的预热帧数
+    int width = 1280;
+    int height = 720;
+    std::string mode = "forward";   // forward / clustered / deferred
+    bool headless = true;
+    std::string shaderDir = "shaders";
+    std::string output;         // 为空时输出到标准输出
+};
+
+struct Summary {
+    double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, min = 0.0, max = 0.0;
+};
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --cubes N        number of cubes (default 1000)\n"
+              << "  --spheres N      number of spheres (default 1000)\n"
+              << "  --lights N       number of point lights (default 32)\n"
+              << "  --frames N       measured frames (default 600)\n"
+              << "  --warmup N       frames rendered before measuring (default 60)\n"
+              << "  --size WxH       framebuffer size (default 1280x720)\n"
+              << "  --mode M         forward | clustered | deferred (default forward)\n"
+              << "  --window         render to a visible window (vsync off) instead of offscreen\n"
+              << "  --shaders DIR    shader directory (default shaders)\n"
+              << "  --out FILE       write JSON to FILE instead of stdout\n";
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--window") == 0) {
+            config.headless = false;
+            continue;
+        }
+        if (!value) return false;
+        ++i;
+        if (std::strcmp(arg, "--cubes") == 0) config.cubes = std::atoi(value);
+        else if (std::strcmp(arg, "--spheres") == 0) config.spheres = std::atoi(value);
+        else if (std::strcmp(arg, "--lights") == 0) config.lights = std::atoi(value);
+        else if (std::strcmp(arg, "--frames") == 0) config.frames = std::atoi(value);
+        else if (std::strcmp(arg, "--warmup") == 0) config.warmup = std::atoi(value);
+        else if (std::strcmp(arg, "--mode") == 0) config.mode = value;
+        else if (std::strcmp(arg, "--shaders") == 0) config.shaderDir = value;
+        else if (std::strcmp(arg, "--out") == 0) config.output = value;
+        else if (std::strcmp(arg, "--size") == 0) {
+            if (std::sscanf(value, "%dx%d", &config.width, &config.height) != 2) return false;
+        } else {
+            return false;
+        }
+    }
+    return config.frames > 0 && config.warmup >= 0 && config.width > 0 && config.height > 0 &&
+           (config.mode == "forward" || config.mode == "clustered" || config.mode == "deferred");
+}
+
+/**
+ * @brief 平均值与最近秩百分位数
+ */
+static Summary summarize(std::vector<double> values) {
+    Summary summary;
+    if (values.empty()) return summary;
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) {
+        size_t rank = (size_t)std::ceil(p / 100.0 * values.size());
+        return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    summary.mean = sum / values.size();
+    summary.p50 = percentile(50.0);
+    summary.p95 = percentile(95.0);
+    summary.p99 = percentile(99.0);
+    summary.min = values.front();
+    summary.max = values.back();
+    return summary;
+}
+
+static std::string jsonString(const char* text) {
+    std::string out = "\"";
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        if ((unsigned char)*c >= 0x20) out += *c;
+    }
+    return out + "\"";
+}
+
+static void writeSummary(std::ostream& out, const char* name, const Summary& s, bool last = false) {
+    out << "    " << jsonString(name) << ": {\"mean\": " << s.mean << ", \"p50\": " << s.p50
+        << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"min\": " << s.min
+        << ", \"max\": " << s.max << "}" << (last ? "\n" : ",\n");
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    const int totalFrames = config.warmup + config.frames;
+
+    HeadlessConfig headless;
+    headless.enabled = config.headless;
+    headless.frameCount = totalFrames;
+    headless.fixedTimeStep = 1.0f / 60.0f;
+
+    std::vector<double> cpuTimes, gpuTimes;
+    double drawCalls = 0.0, triangles = 0.0;
+    int statsFrames = 0;
+    uint64_t droppedFrames = 0;
+    std::string renderer, version;
+
+    try {
+        Window window(config.width, config.height, "opengl_bench", headless);
+        // 窗口模式下关闭垂直同步，否则测到的是刷新间隔
+        if (!config.headless) window.SetSwapInterval(0);
+        renderer = (const char*)glGetString(GL_RENDERER);
+        version = (const char*)glGetString(GL_VERSION);
+
+        const std::string dir = config.shaderDir + "/";
+        Shader shader((dir + "vertex.glsl").c_str(), (dir + "fragment.glsl").c_str());
+        Shader gbufferShader((dir + "vertex.glsl").c_str(), (dir + "gbuffer_fragment.glsl").c_str());
+        Shader deferredShader((dir + "deferred_vertex.glsl").c_str(), (dir + "deferred_fragment.glsl").c_str());
+        window.BindShader(&shader);
+        window.BindDeferredShaders(&gbufferShader, &deferredShader);
+        if (config.mode == "deferred") window.SetRenderMode(RenderMode::DEFERRED_RESULT);
+        if (config.mode == "clustered") window.SetLightingMode(LightingMode::CLUSTERED);
+
+        Camera camera;
+        camera.setPerspective(45.0f, 0.1f, 200.0f);
+        window.BindCamera(&camera);
+
+        // 场景：形状散布在以原点为中心的方形区域内，固定种子保证每次运行相同
+        std::mt19937 rng(42);
+        const int objectCount = config.cubes + config.spheres;
+        const float extent = std::max(5.0f, std::sqrt((float)objectCount) * 1.2f);
+        std::uniform_real_distribution<float> horizontal(-extent, extent);
+        std::uniform_real_distribution<float> vertical(0.0f, 4.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        // 逐个取随机数（函数参数的求值顺序不确定，不同编译器会得到不同的场景）
+        auto randomVec3 = [&rng](std::uniform_real_distribution<float>& x, std::uniform_real_distribution<float>& y,
+                                 std::uniform_real_distribution<float>& z) {
+            float vx = x(rng);
+            float vy = y(rng);
+            float vz = z(rng);
+            return glm::vec3(vx, vy, vz);
+        };
+
+        std::vector<std::unique_ptr<ColoredShape>> shapes;
+        for (int i = 0; i < objectCount; ++i) {
+            glm::vec3 color = randomVec3(unit, unit, unit);
+            ColoredShape* shape = i < config.cubes
+                ? static_cast<ColoredShape*>(new Cube(0.8f, color))
+                : static_cast<ColoredShape*>(new Sphere(0.5f, 36, 18, color));
+            shape->setPosition(randomVec3(horizontal, vertical, horizontal));
+            shape->setRotation(glm::vec3(0.0f, unit(rng) * 360.0f, 0.0f));
+            shapes.emplace_back(shape);
+            window.AddShape(shape);
+        }
+
+        std::vector<std::unique_ptr<Light>> lights;
+        for (int i = 0; i < config.lights; ++i) {
+            glm::vec3 position = randomVec3(horizontal, vertical, horizontal) + glm::vec3(0.0f, 2.0f, 0.0f);
+            Light* light = new Light(POINT_LIGHT, position);
+            glm::vec3 color = glm::vec3(0.5f) + 0.5f * randomVec3(unit, unit, unit);
+            light->setColor(color * 0.05f, color, color);
+            lights.emplace_back(light);
+            window.AddLightSource(light);
+        }
+
+        // 帧时间取自窗口的 Profiler（CPU：beginFrame 到 endFrame；GPU：各 GPU 区段之和），
+        // 阻塞模式保证每帧都有 GPU 结果；预热帧与窗口模式下关闭前多渲染的一帧不计入
+        Profiler& profiler = window.GetProfiler();
+        profiler.setBlocking(true);
+        profiler.setFrameCallback([&](uint64_t frame, double cpuMs, double gpuMs) {
+            if (frame < (uint64_t)config.warmup || frame >= (uint64_t)totalFrames) return;
+            cpuTimes.push_back(cpuMs);
+            gpuTimes.push_back(gpuMs);
+        });
+
+        // 回调在每帧开始时调用，此时 GetRenderStats() 仍是上一帧的统计
+        auto addRenderStats = [&]() {
+            drawCalls += window.GetRenderStats().drawCalls;
+            triangles += window.GetRenderStats().triangles;
+            statsFrames++;
+        };
+
+        // 摄像机路径：绕场景中心一圈，高度与半径缓慢起伏，始终看向中心附近
+        window.SetFrameCallback([&](int frame) {
+            if (frame > config.warmup) addRenderStats();
+            if (frame == totalFrames) {
+                window.Close();
+                return;
+            }
+
+            float t = glm::radians(360.0f * frame / totalFrames);
+            float radius = extent * (1.1f + 0.3f * std::sin(3.0f * t));
+            camera.Position = glm::vec3(radius * std::cos(t), 6.0f + 3.0f * std::sin(2.0f * t), radius * std::sin(t));
+            camera.lookAt(glm::vec3(0.3f * extent * std::sin(t), 1.0f, 0.0f));
+        });
+
+        // 无显示模式在 totalFrames 帧后停止，最后一帧的渲染统计在这里累加；
+        // 窗口模式不按帧数停止，由回调在第 totalFrames 帧开始时累加并关闭窗口
+        window.Run();
+        if (statsFrames < config.frames) addRenderStats();
+        profiler.flush();
+        droppedFrames = profiler.getDroppedFrames();
+        profiler.setFrameCallback(nullptr);
+        window.SetFrameCallback(nullptr);
+
+        // 形状与光源的 GL 资源需在窗口（上下文）销毁前释放
+        shapes.clear();
+        lights.clear();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"config\": {\"cubes\": " << config.cubes << ", \"spheres\": " << config.spheres
+         << ", \"lights\": " << config.lights << ", \"frames\": " << config.frames << ", \"warmup\": " << config.warmup
+         << ", \"width\": " << config.width << ", \"height\": " << config.height
+         << ", \"mode\": " << jsonString(config.mode.c_str()) << ", \"headless\": " << (config.headless ? "true" : "false")
+         << "},\n"
+         << "  \"gl_renderer\": " << jsonString(renderer.c_str()) << ",\n"
+         << "  \"gl_version\": " << jsonString(version.c_str()) << ",\n"
+         << "  \"measured_frames\": {\"cpu\": " << cpuTimes.size() << ", \"gpu\": " << gpuTimes.size() << "},\n"
+         << "  \"dropped_frames\": " << droppedFrames << ",\n"
+         << "  \"avg_draw_calls\": " << drawCalls / std::max(statsFrames, 1) << ",\n"
+         << "  \"avg_triangles\": " << triangles / std::max(statsFrames, 1) << ",\n"
+         << "  \"frame_time_ms\": {\n";
+    writeSummary(json, "cpu", summarize(cpuTimes));
+    writeSummary(json, "gpu", summarize(gpuTimes), true);
+    json << "  }\n}\n";
+
+    if (config.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(config.output);
+        if (!file) {
+            std::cerr << "Failed to open " << config.output << std::endl;
+            return -1;
+        }
+        file << json.str();
+    }
+    return 0;
+}
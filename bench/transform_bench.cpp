@@ -0,0 +1,127 @@
+// 变换基准：100 万个变换的模型矩阵计算
+// 对比逐对象计算（与 Shape::getModelMatrix() 相同的 glm 组合，对象分散在堆上）
+// 与 TransformSystem 的 SoA 批量计算（标量 / SSE / AVX2）
+#include <scene/transform_system.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 模拟 Shape：变换分量与其它成员一起存放在各自的堆对象中
+struct LegacyObject {
+    virtual ~LegacyObject() = default;
+    glm::vec3 position, rotation, scale;
+    glm::vec3 color = glm::vec3(1.0f);
+    float material[12] = {};
+
+    glm::mat4 getModelMatrix() const {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        model = glm::scale(model, scale);
+        return model;
+    }
+};
+
+// 重复若干次取最短时间
+template <typename F>
+static double bestOf(int runs, F&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = Clock::now();
+        fn();
+        best = std::min(best, elapsedMs(start));
+    }
+    return best;
+}
+
+static float maxError(const std::vector<glm::mat4>& reference, const TransformSystem& system) {
+    float error = 0.0f;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        const glm::mat4& m = system.getMatrices()[i];
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                error = std::max(error, std::fabs(m[c][r] - reference[i][c][r]));
+            }
+        }
+    }
+    return error;
+}
+
+int main() {
+    const size_t count = 1000000;
+    const int runs = 5;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> angle(-360.0f, 360.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    TransformSystem system(count);
+    std::vector<std::unique_ptr<LegacyObject>> objects(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 p(position(rng), position(rng), position(rng));
+        glm::vec3 r(angle(rng), angle(rng), angle(rng));
+        glm::vec3 s(scale(rng), scale(rng), scale(rng));
+        system.create(p, r, s);
+        objects[i] = std::make_unique<LegacyObject>();
+        objects[i]->position = p;
+        objects[i]->rotation = r;
+        objects[i]->scale = s;
+    }
+
+    // 逐对象计算，按打乱后的顺序访问以模拟场景中分散的对象
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<glm::mat4> reference(count);
+    double legacyMs = bestOf(runs, [&] {
+        for (size_t i : order) reference[i] = objects[i]->getModelMatrix();
+    });
+    std::printf("%zu transforms, detected SIMD: %s\n\n", count,
+                TransformSystem::getSimdLevelName(TransformSystem::detectSimdLevel()));
+    std::printf("%-28s %10.2f ms\n", "per-object getModelMatrix", legacyMs);
+
+    for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 }) {
+        system.setSimdLevel(level);
+        if (system.getSimdLevel() != level) continue;
+
+        double ms = bestOf(runs, [&] { system.updateAll(); });
+        char label[64];
+        std::snprintf(label, sizeof(label), "SoA updateAll (%s)", TransformSystem::getSimdLevelName(level));
+        std::printf("%-28s %10.2f ms  (%.1fx, max error %.2e)\n", label, ms, legacyMs / ms,
+                    maxError(reference, system));
+    }
+
+    // 只修改一部分变换，update() 跳过未修改的块
+    system.setSimdLevel(TransformSystem::detectSimdLevel());
+    for (int fraction : { 1, 10 }) {
+        size_t moved = count * fraction / 100;
+        double ms = bestOf(runs, [&] {
+            for (size_t i = 0; i < moved; ++i) {
+                system.move((TransformSystem::Handle)i, glm::vec3(0.001f, 0.0f, 0.0f));
+            }
+            system.update();
+        });
+        char label[64];
+        std::snprintf(label, sizeof(label), "move + update %d%%", fraction);
+        std::printf("%-28s %10.2f ms\n", label, ms);
+    }
+
+    double staticMs = bestOf(runs, [&] { system.update(); });
+    std::printf("%-28s %10.4f ms\n", "update (nothing dirty)", staticMs);
+    return 0;
+}
@@ -82,6 +82,19 @@ public:
      */
     void setPerspective(float fovDegrees, float nearPlane, float farPlane);
 
+    /**
+     * @brief 转向世界空间中的目标点（重新计算 Yaw/Pitch，位置不变）
+     * @param target 目标点，不能与 Position 重合
+     */
+    void lookAt(const glm::vec3& target);
+
+    /**
+     * @brief 获取透视投影参数
+     */
+    float getFov() const { return Zoom; }              ///< 垂直视场角（度）
+    float getNearPlane() const { return NearPlane; }
+    float getFarPlane() const { return FarPlane; }
+
     /**
      * @brief 设置是否反转鼠标 X/Y 轴
      * @param invert 对应轴是否反向
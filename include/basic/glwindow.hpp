@@ -8,6 +8,13 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <cstdio>
+#include <cfloat>
 
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
@@ -15,9 +22,21 @@
 
 
 #include "shapes.hpp"
+#include "instancing.hpp"
 #include "shader.hpp"
+#include "uniform_buffer.hpp"
+#include "stream_buffer.hpp"
 #include "light.hpp"
+#include "light_buffer.hpp"
+#include "cluster_buffer.hpp"
 #include "camera.hpp"
+#include "render_queue.hpp"
+#include "gbuffer.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
+#include "frustum.hpp"
+#include "shape_bvh.hpp"
+#include "occlusion.hpp"
 
 /**
  * @brief GLFW 初始化/终止管理器
@@ -26,11 +45,28 @@
  */
 class GLCore {
 public:
-    // 初始化 GLFW（只调用一次）
-    static void Initialize() {
+    /**
+     * @brief 初始化 GLFW（只调用一次）
+     * @param headless 无显示模式：优先使用 GLFW 的 null 平台 + OSMesa 上下文（Mesa llvmpipe 软件渲染），
+     *                 不可用时退回默认平台上的不可见窗口。同一进程内的所有窗口共用这一设置
+     */
+    static void Initialize(bool headless = false) {
         if (s_initialized) return;
 
-        if (!glfwInit()) {
+        bool initialized = false;
+#ifdef GLFW_PLATFORM_NULL
+        if (headless) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            initialized = glfwInit() == GLFW_TRUE;
+            if (initialized) {
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            } else {
+                glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+                std::cerr << "GLFW null platform unavailable, falling back to a hidden window\n";
+            }
+        }
+#endif
+        if (!initialized && !glfwInit()) {
             std::cerr << "Failed to initialize GLFW\n";
             throw std::runtime_error("GLFW init failed");
         }
@@ -38,8 +74,10 @@ public:
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        if (headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
         s_initialized = true;
+        s_headless = headless;
     }
 
     // 终止 GLFW（在程序结束时调用一次）
@@ -51,9 +89,11 @@ public:
     }
 
     static bool is_initialized() {return GLCore::s_initialized;}
+    static bool is_headless() {return GLCore::s_headless;}
 
 private:
     static inline bool s_initialized = false;
+    static inline bool s_headless = false;
 };
 
 #define WINDOW_BASIC                // 窗口基本功能
@@ -64,23 +104,63 @@ enum class RenderMode {
     VERTEX_SHADER_RESULT = 0,    // 顶点着色器结果
     RASTERIZED_RESULT = 1,       // 光栅化后结果
     FRAGMENT_SHADER_RESULT = 2,  // 片段着色后结果
-    FINAL_RESULT = 3             // 最终处理结果
+    FINAL_RESULT = 3,            // 最终处理结果
+    DEFERRED_RESULT = 4          // 延迟着色结果（需先调用 BindDeferredShaders）
+};
+
+// 光照模式枚举（仅在 FINAL_RESULT 下生效）
+enum class LightingMode {
+    FORWARD = 0,    // 每个片段遍历全部光源（LightData UBO）
+    CLUSTERED = 1   // 每个片段只遍历所在簇的光源（纹理缓冲）
+};
+
+// 视锥体剔除方式
+enum class CullingMode {
+    NONE = 0,       // 不剔除
+    LINEAR = 1,     // 逐个测试全部形状（SIMD 批量）
+    BVH = 2         // 遍历动态 BVH
+};
+
+/**
+ * @brief 无显示环境下的离屏渲染设置
+ *
+ * 启用后不显示窗口、不处理输入，帧渲染到指定尺寸的 FBO 中，可按帧保存为 PPM 图像。
+ */
+struct HeadlessConfig {
+    bool enabled = false;
+    int frameCount = 0;         // Run() 渲染的帧数；0 表示直到 Close()
+    std::string dumpPattern;    // 非空时保存帧，路径中恰好一个 %d（可带 0 填充与宽度，如 %04d）替换为帧号，%% 表示 %
+    int dumpInterval = 1;       // 每隔多少帧保存一次
+    float fixedTimeStep = 0.0f; // 大于 0 时着色器看到的时间为 帧号 × 步长（结果可复现），否则为实际时间
 };
 
 class Window {
 public:
+    /**
+     * @brief 每帧开始时（更新摄像机与剔除之前）调用的回调，参数为帧号
+     */
+    using FrameCallback = std::function<void(int frame)>;
+
     /**
      * @brief 创建并初始化一个窗口
      * @param width 窗口宽度（像素）
      * @param height 窗口高度（像素）
      * @param title 窗口标题
+     * @param headless 无显示模式设置（启用时 width/height 为离屏帧缓冲的尺寸）
      *
      * 该构造器会：确保 GLFW 被初始化、创建 GLFW 窗口、设置当前上下文、初始化 GLEW（仅首次）、设置视口并启用深度测试。
      */
-    WINDOW_BASIC explicit Window(int width = 800, int height = 600, const char* title = "OpenGL Window")
-        : m_width(width), m_height(height), m_title(title), m_lastCameraOutput(0.0f)
+    WINDOW_BASIC explicit Window(int width = 800, int height = 600, const char* title = "OpenGL Window",
+                                 const HeadlessConfig& headless = HeadlessConfig())
+        : m_width(width), m_height(height), m_title(title), m_headless(headless), m_lastCameraOutput(0.0f)
     {
-        if (!GLCore::is_initialized()) GLCore::Initialize(); // 确保 GLFW 已初始化
+        std::string dumpPath;
+        if (!m_headless.dumpPattern.empty() && !FormatFramePath(m_headless.dumpPattern, 0, dumpPath)) {
+            std::cerr << "Invalid dump pattern \"" << m_headless.dumpPattern << "\": expected exactly one %d\n";
+            throw std::invalid_argument("invalid dump pattern");
+        }
+
+        if (!GLCore::is_initialized()) GLCore::Initialize(m_headless.enabled); // 确保 GLFW 已初始化
         
         // 创建窗口
         this->m_window = glfwCreateWindow(m_width, m_height, m_title, nullptr, nullptr);
@@ -94,7 +174,9 @@ public:
         // 初始化 GLEW（只在第一个窗口调用）
         if (!s_glewInitialized) {
             glewExperimental = GL_TRUE;
-            if (glewInit() != GLEW_OK) {
+            GLenum glewResult = glewInit();
+            // 无显示时 GLX 扩展无法查询，核心与 ARB 函数已加载，可以继续
+            if (glewResult != GLEW_OK && !(m_headless.enabled && glewResult == GLEW_ERROR_NO_GLX_DISPLAY)) {
                 glfwDestroyWindow(this->m_window);
                 std::cerr << "Failed to initialize GLEW\n";
                 throw std::runtime_error("GLEW init failed");
@@ -104,10 +186,48 @@ public:
 
         glViewport(0, 0, m_width, m_height);
         glEnable(GL_DEPTH_TEST);
+
+        // 每帧数据的 UBO 与实例数据都经流式环形缓冲写入，避免与 GPU 仍在读取的旧数据同步
+        m_uniformAlignment = StreamBuffer::getUniformAlignment();
+        m_frameStream = std::make_unique<StreamBuffer>(GL_UNIFORM_BUFFER, FRAME_STREAM_SIZE);
+        m_instanceStream = std::make_unique<StreamBuffer>(GL_ARRAY_BUFFER, INSTANCE_STREAM_SIZE);
+        m_lightBuffer = std::make_unique<LightBuffer>();
+        m_clusterBuffer = std::make_unique<ClusterLightBuffer>();
+        m_frameGraph = std::make_unique<FrameGraph>();
+        m_profiler = std::make_unique<Profiler>();
+        if (m_headless.enabled) createOffscreenTarget();
+
+        // 性能分析面板（ImGui）；只显示不交互，因此不接管 GLFW 回调
+        if (!m_headless.enabled) {
+            IMGUI_CHECKVERSION();
+            m_imguiContext = ImGui::CreateContext();
+            ImGui::StyleColorsDark();
+            ImGui_ImplGlfw_InitForOpenGL(this->m_window, false);
+            ImGui_ImplOpenGL3_Init("#version 330 core");
+        }
         s_windowCount++;
     }
 
     WINDOW_BASIC ~Window() {
+        // GL 资源需在上下文销毁前释放
+        m_frameStream.reset();
+        m_instanceStream.reset();
+        m_lightBuffer.reset();
+        m_clusterBuffer.reset();
+        m_frameGraph.reset();
+        m_profiler.reset();
+        if (m_imguiContext) {
+            ImGui::SetCurrentContext(m_imguiContext);
+            ImGui_ImplOpenGL3_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext(m_imguiContext);
+            m_imguiContext = nullptr;
+        }
+        if (m_offscreenFBO) {
+            glDeleteFramebuffers(1, &m_offscreenFBO);
+            glDeleteRenderbuffers(1, &m_offscreenColor);
+            glDeleteRenderbuffers(1, &m_offscreenDepth);
+        }
         if (this->m_window) {
             glfwDestroyWindow(this->m_window);
             this->m_window = nullptr;
@@ -152,12 +272,128 @@ public:
         glfwSwapBuffers(this->m_window);
     }
 
+    /**
+     * @brief 是否为无显示模式
+     */
+    WINDOW_BASIC bool IsHeadless() const {
+        return m_headless.enabled;
+    }
+
+    /**
+     * @brief 每帧最终写入的帧缓冲（无显示模式下为离屏 FBO，否则为 0）
+     */
+    WINDOW_BASIC GLuint GetTargetFramebuffer() const {
+        return m_offscreenFBO;
+    }
+
+    /**
+     * @brief 把帧号代入保存路径模式
+     * @param pattern 路径模式：恰好包含一个 %d 或 %i（可带 0 填充与宽度，如 %04d），%% 表示字面的 %
+     * @param frame 帧号
+     * @param path 输出路径
+     * @return 模式合法时返回 true；其他转换说明或转换个数不为一时返回 false
+     *
+     * 手动替换而不把用户给出的模式当作 printf 格式串，避免 %s、%n 等造成未定义行为。
+     */
+    WINDOW_BASIC static bool FormatFramePath(const std::string& pattern, int frame, std::string& path) {
+        path.clear();
+        int conversions = 0;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] != '%') {
+                path += pattern[i];
+                continue;
+            }
+            if (++i < pattern.size() && pattern[i] == '%') {
+                path += '%';
+                continue;
+            }
+            bool zeroPad = i < pattern.size() && pattern[i] == '0';
+            if (zeroPad) ++i;
+            int width = 0;
+            for (; i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9'; ++i) {
+                width = width * 10 + (pattern[i] - '0');
+                if (width > 64) return false;
+            }
+            if (i == pattern.size() || (pattern[i] != 'd' && pattern[i] != 'i') || ++conversions > 1) return false;
+
+            std::ostringstream number;
+            number << std::setfill(zeroPad ? '0' : ' ') << std::setw(width) << frame;
+            path += number.str();
+        }
+        return conversions == 1;
+    }
+
+    /**
+     * @brief 把最近一帧的画面保存为二进制 PPM（P6）图像
+     * @param path 文件路径
+     * @return 回读与写入都成功返回 true（回读产生 GL 错误时不写文件）
+     *
+     * 需在帧渲染完成后、交换缓冲前调用（Run() 按 HeadlessConfig::dumpPattern 自动调用）。
+     */
+    WINDOW_BASIC bool SaveFrame(const std::string& path) const {
+        std::vector<unsigned char> pixels((size_t)m_width * m_height * 3);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_offscreenFBO);
+        if (!m_offscreenFBO) glReadBuffer(GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        // 丢弃之前累积的错误，下面只检查回读本身（上下文丢失时 glGetError 可能一直返回错误，因此限定次数）
+        for (int i = 0; i < 16 && glGetError() != GL_NO_ERROR; ++i) {}
+        glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+        GLenum error = glGetError();
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Failed to read back frame for " << path << ": GL error 0x" << std::hex << error << std::dec << "\n";
+            return false;
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to open " << path << " for writing\n";
+            return false;
+        }
+        file << "P6\n" << m_width << " " << m_height << "\n255\n";
+        // OpenGL 的第一行在底部，图像文件的第一行在顶部
+        const size_t rowBytes = (size_t)m_width * 3;
+        for (int y = m_height - 1; y >= 0; --y) {
+            file.write(reinterpret_cast<const char*>(&pixels[y * rowBytes]), rowBytes);
+        }
+        return (bool)file;
+    }
+
     /**
      * @brief 增加形状。
      * @param shape 新形状。
      */
     WINDOW_BASIC void AddShape(ColoredShape* shape) {
         this->m_shape_list.push_back(shape);
+        this->m_shapeBVH.add(shape);
+    }
+
+    /**
+     * @brief 移除形状（不会释放形状本身）。
+     * @param shape 要移除的形状。
+     */
+    WINDOW_BASIC void RemoveShape(ColoredShape* shape) {
+        auto it = std::find(m_shape_list.begin(), m_shape_list.end(), shape);
+        if (it == m_shape_list.end()) return;
+        m_shape_list.erase(it);
+        m_shapeBVH.remove(shape);
+    }
+
+    /**
+     * @brief 获取场景形状的 BVH（可用于射线拾取）
+     */
+    WINDOW_BASIC const ShapeBVH& GetShapeBVH() const {
+        return this->m_shapeBVH;
+    }
+
+    /**
+     * @brief 增加实例化批次（每个批次每帧一次绘制调用）。
+     * @param batch 实例化批次。
+     * @param streamed 实例每帧都会变化时置为 true，实例数据经流式缓冲写入。
+     */
+    WINDOW_BASIC void AddInstanceBatch(InstanceBatch* batch, bool streamed = false) {
+        if (streamed) batch->setStreamBuffer(m_instanceStream.get());
+        this->m_batch_list.push_back(batch);
     }
 
     /**
@@ -166,6 +402,36 @@ public:
      */
     WINDOW_BASIC void BindShader(Shader* shader) {
         this->m_shader = shader;
+
+        // 预先解析每帧使用的 uniform 句柄
+        m_uniforms.renderMode        = shader->getUniform("renderMode");
+        m_uniforms.useInstancing     = shader->getUniform("useInstancing");
+        m_uniforms.lightingMode      = shader->getUniform("lightingMode");
+        m_uniforms.materialAmbient   = shader->getUniform("material.ambient");
+        m_uniforms.materialDiffuse   = shader->getUniform("material.diffuse");
+        m_uniforms.materialSpecular  = shader->getUniform("material.specular");
+        m_uniforms.materialShininess = shader->getUniform("material.shininess");
+    }
+
+    /**
+     * @brief 绑定延迟着色使用的着色器，绑定后渲染模式中会出现 DEFERRED_RESULT。
+     * @param geometry 几何阶段着色器（写入 G-buffer）
+     * @param lighting 光照解析着色器（全屏绘制）
+     */
+    WINDOW_BASIC void BindDeferredShaders(Shader* geometry, Shader* lighting) {
+        this->m_gbufferShader = geometry;
+        this->m_deferredShader = lighting;
+
+        m_deferredUniforms.useInstancing         = geometry->getUniform("useInstancing");
+        m_deferredUniforms.materialSpecular      = geometry->getUniform("material.specular");
+        m_deferredUniforms.materialShininess     = geometry->getUniform("material.shininess");
+        m_deferredUniforms.inverseViewProjection = lighting->getUniform("inverseViewProjection");
+
+        // 采样器绑定的纹理单元固定不变，只需设置一次
+        lighting->use();
+        lighting->setInt("gAlbedoSpecular", GBUFFER_ALBEDO_UNIT);
+        lighting->setInt("gNormalShininess", GBUFFER_NORMAL_UNIT);
+        lighting->setInt("gDepth", GBUFFER_DEPTH_UNIT);
     }
 
     /**
@@ -184,72 +450,129 @@ public:
     }
 
     /**
-     * @brief 清理当前帧的颜色/深度缓冲区
-     * 本实现会使用固定的背景颜色并清除颜色与深度缓冲。若需自定义背景色请修改此方法或在外部调用 glClearColor
+     * @brief 清理当前绑定帧缓冲的颜色/深度缓冲区
+     * 使用窗口背景色（与 Run() 中帧图第一次写入默认帧缓冲时的清除颜色相同）。Run() 自身不调用此方法
      */
     WINDOW_BASIC void Clear() {
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClearColor(m_clearColor.r, m_clearColor.g, m_clearColor.b, m_clearColor.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
     // 主循环
     WINDOW_BASIC void Run() {
         float lastFrame = 0.0f, currentFrame = 0.0f, deltaTime = 0.0f;
-        std::cout << " --------------- " << std::endl;
-        std::cout << "Window started." << std::endl;
-        std::cout << "Press WSAD to move. " << std::endl;
-        std::cout << "Press LShift to dive, press SPACEBAR to float. " << std::endl;
-        std::cout << "Press V to change vertical mouse behaviour, press B to change horizontal mouse behaviour." << std::endl;
-        std::cout << "Press U and I to change rendering mode." << std::endl;
-        std::cout << "Press ESC to quit." << std::endl;
-        std::cout << " --------------- " << std::endl;
-
-        while (!this->ShouldClose()) {
-            this->Clear();
-            m_shader->use();
-
-            // 上传视图与投影矩阵到着色器（uniform 名称需与着色器代码一致）
-            glm::mat4 view = m_camera->getViewMatrix();
-            glm::mat4 projection = m_camera->getProjectionMatrix(800.0f / 600.0f);
-            m_shader->setMat4("view", view);
-            m_shader->setMat4("projection", projection);
+        // 无显示模式下没有输入，不打印按键说明
+        if (!m_headless.enabled) {
+            std::cout << " --------------- " << std::endl;
+            std::cout << "Window started." << std::endl;
+            std::cout << "Press WSAD to move. " << std::endl;
+            std::cout << "Press LShift to dive, press SPACEBAR to float. " << std::endl;
+            std::cout << "Press V to change vertical mouse behaviour, press B to change horizontal mouse behaviour." << std::endl;
+            std::cout << "Press U and I to change rendering mode (mode 4 is deferred shading)." << std::endl;
+            std::cout << "Press R to toggle sorted render queue, press P to print render stats." << std::endl;
+            std::cout << "Press C to toggle clustered lighting, press F to cycle frustum culling (off / linear / BVH)." << std::endl;
+            std::cout << "Press O to toggle software occlusion culling, press L to toggle sphere LOD." << std::endl;
+            std::cout << "Press T to toggle the profiler overlay, press K to write trace.json." << std::endl;
+            std::cout << "Press ESC to quit." << std::endl;
+            std::cout << " --------------- " << std::endl;
+        }
 
-            // 设置渲染模式
-            m_shader->setInt("renderMode", static_cast<int>(m_renderMode));
+        TRACE_THREAD_NAME("main");
+        for (int frame = 0; !this->ShouldClose(); ++frame) {
+            if (m_headless.enabled && m_headless.frameCount > 0 && frame >= m_headless.frameCount) break;
+            TRACE_ZONE("frame");
 
             // 更新时间
-            currentFrame = (float)glfwGetTime();
+            if (m_headless.fixedTimeStep > 0.0f) {
+                currentFrame = frame * m_headless.fixedTimeStep;
+            } else {
+                currentFrame = (float)glfwGetTime();
+            }
             deltaTime = currentFrame - lastFrame;
             lastFrame = currentFrame;
-            this->key_callback(&deltaTime);
-
-            // 设置视点位置
-            m_shader->setVec3("viewPos", m_camera->Position);
-            
-            // 设置材质属性
-            m_shader->setVec3("material.ambient",  glm::vec3(1.0f, 1.0f, 1.0f));
-            m_shader->setVec3("material.diffuse",  glm::vec3(1.0f, 0.5f, 1.0f));
-            m_shader->setVec3("material.specular", glm::vec3(0.5f, 0.5f, 0.5f));
-            m_shader->setFloat("material.shininess", 32.0f);
-            
-            // 设置光源属性
-            for (auto& light : m_light_list) {
-                light->setUniform(m_shader->ID, "light");
+            if (m_frameCallback) m_frameCallback(frame);
+            if (!m_headless.enabled) this->key_callback(&deltaTime);
+
+            m_profiler->beginFrame();
+            m_profiler->beginZone("frame setup");
+            m_frameStream->beginFrame();
+            m_instanceStream->beginFrame();
+
+            // 每帧数据只写入 UBO 一次，所有着色器程序通过绑定点共享
+            glm::mat4 view = m_camera->getViewMatrix();
+            FrameData frameData;
+            frameData.view = view;
+            frameData.projection = m_camera->getProjectionMatrix((float)m_width / (float)m_height);
+            frameData.viewProjection = frameData.projection * view;
+            frameData.cameraPosition = glm::vec4(m_camera->Position, 1.0f);
+            frameData.time = glm::vec4(currentFrame, deltaTime, 0.0f, 0.0f);
+            GLintptr frameOffset = m_frameStream->write(&frameData, sizeof(FrameData), m_uniformAlignment);
+            glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, m_frameStream->getID(), frameOffset, sizeof(FrameData));
+
+            m_profiler->endZone();
+
+            m_renderStats.reset();
+            m_renderStats.frameTime = deltaTime;
+            {
+                Profiler::Scope zone(m_profiler.get(), "culling", false);
+                TRACE_ZONE("culling");
+                // 本帧修改过变换的形状在这里统一更新包围体并通知 BVH
+                Shape::flushTransforms();
+                this->cullShapes(frameData.viewProjection);
+                if (m_occlusionCulling) this->cullOccluded(frameData.viewProjection);
+                this->updateLOD();
+            }
+
+            // 每帧重新声明渲染通道，由帧图剔除、排序并分配（别名）中间纹理；默认帧缓冲在第一次写入时清除
+            m_frameGraph->reset();
+            FrameGraph::Resource backbuffer =
+                m_frameGraph->importFramebuffer("backbuffer", m_offscreenFBO, m_width, m_height, m_clearColor);
+            if (m_renderMode == RenderMode::DEFERRED_RESULT) {
+                this->addDeferredPasses(frameData, backbuffer);
+            } else {
+                m_frameGraph->addPass("forward", [this, view](const FrameGraph&) { this->renderForward(view); })
+                    .write(backbuffer);
+            }
+            {
+                Profiler::Scope zone(m_profiler.get(), "frame graph compile", false);
+                TRACE_ZONE("frame graph compile");
+                m_frameGraph->compile();
+            }
+            {
+                TRACE_ZONE("frame graph execute");
+                m_frameGraph->execute(m_profiler.get());
             }
 
-            for (auto& shape : m_shape_list) {
-                // 为每个形状设置model矩阵
-                glm::mat4 model = shape->getModelMatrix();
-                m_shader->setMat4("model", model);
-                shape->draw(*(this->m_shader));
+            if (m_imguiContext && m_showProfiler) {
+                Profiler::Scope zone(m_profiler.get(), "overlay");
+                TRACE_ZONE("overlay");
+                this->drawProfilerOverlay();
+            }
+
+            m_frameStream->endFrame();
+            m_instanceStream->endFrame();
+
+            if (!m_headless.dumpPattern.empty() && frame % std::max(1, m_headless.dumpInterval) == 0) {
+                std::string path;
+                FormatFramePath(m_headless.dumpPattern, frame, path);  // 构造时已校验
+                this->SaveFrame(path);
             }
 
             // 刷新缓冲区，并轮询。
-            this->SwapBuffers();
+            {
+                Profiler::Scope zone(m_profiler.get(), "swap", false);
+                TRACE_ZONE("swap");
+                if (m_headless.enabled) {
+                    glFlush();
+                } else {
+                    this->SwapBuffers();
+                }
+            }
             this->PollEvents();
+            m_profiler->endFrame();
         }
 
-        std::cout << "Quit." << std::endl;
+        if (!m_headless.enabled) std::cout << "Quit." << std::endl;
     }
 
     // --------------------------- 事件处理 ---------------------------
@@ -270,19 +593,140 @@ public:
         glfwSetCursorPosCallback(this->m_window, mouse_callback);
     }
 
+    /**
+     * @brief 获取上一帧的渲染统计（绘制调用、绑定次数等）
+     */
+    WINDOW_BASIC const RenderStats& GetRenderStats() const {
+        return this->m_renderStats;
+    }
+
+    /**
+     * @brief 帧内各阶段的 CPU / GPU 计时
+     */
+    WINDOW_BASIC Profiler& GetProfiler() {
+        return *this->m_profiler;
+    }
+
+    /**
+     * @brief 设置是否使用排序渲染队列
+     * @param enabled 为 false 时按插入顺序逐个绘制（用于对比）
+     */
+    WINDOW_BASIC void SetUseRenderQueue(bool enabled) {
+        this->m_useRenderQueue = enabled;
+    }
+
+    /**
+     * @brief 设置每帧开始时调用的回调（例如按脚本移动摄像机、计时）
+     */
+    WINDOW_BASIC void SetFrameCallback(FrameCallback callback) {
+        this->m_frameCallback = std::move(callback);
+    }
+
+    /**
+     * @brief 设置渲染模式（DEFERRED_RESULT 需先调用 BindDeferredShaders）
+     */
+    WINDOW_BASIC void SetRenderMode(RenderMode mode) {
+        if (mode == RenderMode::DEFERRED_RESULT && !m_gbufferShader) return;
+        this->m_renderMode = mode;
+    }
+
+    WINDOW_BASIC void SetLightingMode(LightingMode mode) {
+        this->m_lightingMode = mode;
+    }
+
+    WINDOW_BASIC void SetCullingMode(CullingMode mode) {
+        this->m_cullingMode = mode;
+    }
+
+    /**
+     * @brief 设置交换缓冲时等待的垂直同步次数（0 关闭垂直同步，测量帧时间时使用）
+     */
+    WINDOW_BASIC void SetSwapInterval(int interval) {
+        glfwMakeContextCurrent(this->m_window);
+        glfwSwapInterval(interval);
+    }
+
 private:
     int m_width;            // 当前窗口宽
     int m_height;           // 当前窗口高
     const char* m_title;    // 当前窗口标题
     GLFWwindow* m_window;   // 当前实例窗口
     Shader* m_shader;         // 使用的着色器
+    Shader* m_gbufferShader = nullptr;   // 延迟着色几何阶段着色器
+    Shader* m_deferredShader = nullptr;  // 延迟着色光照解析着色器
     Camera* m_camera;         // 当前主镜头
 
+    // 每帧使用的 uniform 句柄（BindShader 时解析）
+    struct FrameUniformHandles {
+        UniformHandle renderMode;
+        UniformHandle useInstancing;
+        UniformHandle lightingMode;
+        UniformHandle materialAmbient;
+        UniformHandle materialDiffuse;
+        UniformHandle materialSpecular;
+        UniformHandle materialShininess;
+    } m_uniforms;
+
+    // 延迟着色使用的 uniform 句柄（BindDeferredShaders 时解析）
+    struct DeferredUniformHandles {
+        UniformHandle useInstancing;
+        UniformHandle materialSpecular;
+        UniformHandle materialShininess;
+        UniformHandle inverseViewProjection;
+    } m_deferredUniforms;
+
     std::vector<ColoredShape*> m_shape_list;  // 形状列表
     std::vector<Light*> m_light_list;         // 光源列表
+    std::vector<InstanceBatch*> m_batch_list; // 实例化批次列表
 
     // 渲染模式
     RenderMode m_renderMode = RenderMode::FINAL_RESULT;
+    LightingMode m_lightingMode = LightingMode::FORWARD;
+
+    // 每帧数据与实例数据的流式缓冲（每帧可写入的字节数）
+    static constexpr GLsizeiptr FRAME_STREAM_SIZE = 4 * 1024;
+    static constexpr GLsizeiptr INSTANCE_STREAM_SIZE = 4 * 1024 * 1024;
+    std::unique_ptr<StreamBuffer> m_frameStream;
+    std::unique_ptr<StreamBuffer> m_instanceStream;
+    GLsizeiptr m_uniformAlignment = 256;
+
+    // 光源 UBO
+    std::unique_ptr<LightBuffer> m_lightBuffer;
+    std::unique_ptr<ClusterLightBuffer> m_clusterBuffer;
+    std::unique_ptr<FrameGraph> m_frameGraph;   // 每帧的渲染通道与中间纹理
+    std::unique_ptr<Profiler> m_profiler;       // 各阶段 CPU / GPU 计时
+    ImGuiContext* m_imguiContext = nullptr;     // 性能分析面板（无显示模式下不创建）
+    bool m_showProfiler = false;
+    glm::vec4 m_clearColor = glm::vec4(0.2f, 0.3f, 0.3f, 1.0f);  // 背景色
+
+    FrameCallback m_frameCallback;  // 每帧开始时的回调
+
+    // 无显示模式与离屏帧缓冲
+    HeadlessConfig m_headless;
+    GLuint m_offscreenFBO = 0;
+    GLuint m_offscreenColor = 0;
+    GLuint m_offscreenDepth = 0;
+
+    // 渲染队列
+    RenderQueue m_renderQueue;
+    RenderStats m_renderStats;
+    bool m_useRenderQueue = true;
+
+    // 视锥体剔除
+    CullingMode m_cullingMode = CullingMode::BVH;
+    ShapeBVH m_shapeBVH;                                // 场景形状的动态 BVH
+    std::vector<ColoredShape*> m_visibleShapes;         // 本帧通过剔除的形状
+    std::vector<float> m_cullX, m_cullY, m_cullZ, m_cullRadius;  // 包围球（SoA）
+    std::vector<uint8_t> m_cullVisible;
+
+    // 软件遮挡剔除（CPU 上的低分辨率 Hi-Z）
+    bool m_occlusionCulling = false;
+    OcclusionCuller m_occlusionCuller;
+    std::vector<glm::vec3> m_occluderVertices;
+    std::vector<uint32_t> m_occluderIndices;
+
+    // 细节层级
+    bool m_lodEnabled = true;
 
     static inline bool s_glewInitialized = false;
     static inline int s_windowCount = 0;
@@ -290,6 +734,28 @@ private:
     // 控制台输出时间间隔
     float m_lastCameraOutput;
 
+    /**
+     * @brief 私有函数：创建无显示模式下的离屏帧缓冲（RGBA8 颜色 + 24 位深度）
+     */
+    void createOffscreenTarget() {
+        glGenRenderbuffers(1, &m_offscreenColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+        glGenRenderbuffers(1, &m_offscreenDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &m_offscreenFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_offscreenColor);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_offscreenDepth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Offscreen framebuffer is incomplete\n";
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
 
     /**
      * @brief 私有函数：键盘行为。
@@ -342,12 +808,393 @@ private:
         lastUState = uState;
         lastIState = iState;
 
+        // 渲染队列切换与统计输出
+        static int lastRState = GLFW_RELEASE;
+        static int lastPState = GLFW_RELEASE;
+        int rState = glfwGetKey(this->m_window, GLFW_KEY_R);
+        int pState = glfwGetKey(this->m_window, GLFW_KEY_P);
+        if (rState == GLFW_PRESS && lastRState == GLFW_RELEASE) {
+            m_useRenderQueue = !m_useRenderQueue;
+            std::cout << "Render queue " << (m_useRenderQueue ? "ON" : "OFF") << std::endl;
+        }
+        if (pState == GLFW_PRESS && lastPState == GLFW_RELEASE) {
+            printRenderStats();
+            MeshCache::printStats(std::cout);
+            m_frameGraph->print(std::cout);
+        }
+        lastRState = rState;
+        lastPState = pState;
+
+        // 分簇光照切换
+        static int lastCState = GLFW_RELEASE;
+        int cState = glfwGetKey(this->m_window, GLFW_KEY_C);
+        if (cState == GLFW_PRESS && lastCState == GLFW_RELEASE) {
+            m_lightingMode = (m_lightingMode == LightingMode::FORWARD) ? LightingMode::CLUSTERED : LightingMode::FORWARD;
+            std::cout << "Clustered lighting " << (m_lightingMode == LightingMode::CLUSTERED ? "ON" : "OFF") << std::endl;
+        }
+        lastCState = cState;
+
+        // 视锥体剔除方式切换：关闭 → 线性 → BVH
+        static int lastFState = GLFW_RELEASE;
+        int fState = glfwGetKey(this->m_window, GLFW_KEY_F);
+        if (fState == GLFW_PRESS && lastFState == GLFW_RELEASE) {
+            m_cullingMode = static_cast<CullingMode>((static_cast<int>(m_cullingMode) + 1) % 3);
+            const char* names[3] = { "OFF", "LINEAR", "BVH" };
+            std::cout << "Frustum culling: " << names[static_cast<int>(m_cullingMode)] << std::endl;
+        }
+        lastFState = fState;
+
+        // 遮挡剔除切换
+        static int lastOState = GLFW_RELEASE;
+        int oState = glfwGetKey(this->m_window, GLFW_KEY_O);
+        if (oState == GLFW_PRESS && lastOState == GLFW_RELEASE) {
+            m_occlusionCulling = !m_occlusionCulling;
+            std::cout << "Occlusion culling " << (m_occlusionCulling ? "ON" : "OFF") << std::endl;
+        }
+        lastOState = oState;
+
+        // LOD 切换
+        static int lastLState = GLFW_RELEASE;
+        int lState = glfwGetKey(this->m_window, GLFW_KEY_L);
+        if (lState == GLFW_PRESS && lastLState == GLFW_RELEASE) {
+            m_lodEnabled = !m_lodEnabled;
+            std::cout << "Sphere LOD " << (m_lodEnabled ? "ON" : "OFF") << std::endl;
+        }
+        lastLState = lState;
+
+        // 性能分析面板切换
+        static int lastTState = GLFW_RELEASE;
+        int tState = glfwGetKey(this->m_window, GLFW_KEY_T);
+        if (tState == GLFW_PRESS && lastTState == GLFW_RELEASE) {
+            m_showProfiler = !m_showProfiler;
+        }
+        lastTState = tState;
+
+        // 写出目前为止记录的时间线（需以 ENABLE_TRACING 编译）
+        static int lastKState = GLFW_RELEASE;
+        int kState = glfwGetKey(this->m_window, GLFW_KEY_K);
+        if (kState == GLFW_PRESS && lastKState == GLFW_RELEASE) {
+#if defined(ENGINE_TRACING)
+            if (Trace::writeChromeTrace("trace.json")) {
+                std::cout << "Wrote " << Trace::getEventCount() << " trace events to trace.json";
+                if (uint64_t overwritten = Trace::getDroppedCount()) {
+                    std::cout << " (buffer full: the oldest " << overwritten << " events were overwritten)";
+                }
+                std::cout << std::endl;
+            }
+#else
+            std::cout << "Tracing is disabled (configure with -DENABLE_TRACING=ON)" << std::endl;
+#endif
+        }
+        lastKState = kState;
+
         // 按ESC以退出。
         if (glfwGetKey(this->m_window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
             glfwSetWindowShouldClose(this->m_window, GLFW_TRUE);
         }
     }
 
+    /**
+     * @brief 前向渲染：几何与光照在同一次绘制中完成
+     * @param view 视图矩阵
+     */
+    void renderForward(const glm::mat4& view) {
+        m_shader->use();
+
+        // 设置渲染模式
+        m_shader->setInt(m_uniforms.renderMode, static_cast<int>(m_renderMode));
+        m_shader->setInt(m_uniforms.useInstancing, 0);
+
+        // 设置材质属性
+        m_shader->setVec3(m_uniforms.materialAmbient,  glm::vec3(1.0f, 1.0f, 1.0f));
+        m_shader->setVec3(m_uniforms.materialDiffuse,  glm::vec3(1.0f, 0.5f, 1.0f));
+        m_shader->setVec3(m_uniforms.materialSpecular, glm::vec3(0.5f, 0.5f, 0.5f));
+        m_shader->setFloat(m_uniforms.materialShininess, 32.0f);
+        
+        // 上传光源
+        m_shader->setInt(m_uniforms.lightingMode, static_cast<int>(m_lightingMode));
+        if (m_lightingMode == LightingMode::CLUSTERED) {
+            // 在 CPU 上把光源分配到视锥体簇中，片段只遍历所在簇的光源
+            m_clusterBuffer->update(m_light_list, view, glm::radians(m_camera->getFov()),
+                                    (float)m_width / (float)m_height,
+                                    m_camera->getNearPlane(), m_camera->getFarPlane());
+            m_clusterBuffer->bind(*m_shader, m_width, m_height);
+        } else {
+            // 所有光源打包进 UBO，一次上传
+            m_lightBuffer->upload(m_light_list);
+        }
+
+        this->drawScene(m_shader, view);
+    }
+
+    /**
+     * @brief 延迟渲染：先把几何写入 G-buffer，再用一次全屏绘制累加所有光源
+     * @param frameData 本帧的摄像机数据
+     * @param backbuffer 帧图中导入的默认帧缓冲
+     *
+     * G-buffer 是帧图中的瞬态纹理，只活到光照通道结束，之后的通道可以复用其显存。
+     */
+    void addDeferredPasses(const FrameData& frameData, FrameGraph::Resource backbuffer) {
+        GBuffer gbuffer = GBuffer::declare(*m_frameGraph, m_width, m_height);
+
+        // 几何阶段
+        FrameGraph::PassBuilder geometry = m_frameGraph->addPass("gbuffer", [this, frameData](const FrameGraph&) {
+            m_gbufferShader->use();
+            m_gbufferShader->setInt(m_deferredUniforms.useInstancing, 0);
+            m_gbufferShader->setVec3(m_deferredUniforms.materialSpecular, glm::vec3(0.5f, 0.5f, 0.5f));
+            m_gbufferShader->setFloat(m_deferredUniforms.materialShininess, 32.0f);
+            this->drawScene(m_gbufferShader, frameData.view);
+        });
+        gbuffer.declareWrites(geometry);
+
+        // 光照解析阶段：每个像素只计算一次光照；背景像素被丢弃，保留清除颜色
+        FrameGraph::PassBuilder lighting =
+            m_frameGraph->addPass("deferred_lighting", [this, frameData, gbuffer](const FrameGraph& graph) {
+                m_lightBuffer->upload(m_light_list);
+                m_deferredShader->use();
+                m_deferredShader->setMat4(m_deferredUniforms.inverseViewProjection,
+                                          glm::inverse(frameData.viewProjection));
+                gbuffer.bindTextures(graph);
+                glDisable(GL_DEPTH_TEST);
+                graph.drawFullscreenTriangle();
+                glEnable(GL_DEPTH_TEST);
+                m_renderStats.drawCalls++;
+                m_renderStats.programBinds++;
+            });
+        gbuffer.declareReads(lighting);
+        lighting.write(backbuffer);
+    }
+
+    /**
+     * @brief 视锥体剔除
+     * @param viewProjection 本帧的视图投影矩阵
+     *
+     * LINEAR：先批量测试包围球，再对通过的形状测试包围盒；BVH：遍历层次结构。
+     * 结果写入 m_visibleShapes，并在 m_renderStats 中记录可见/剔除数量。
+     */
+    void cullShapes(const glm::mat4& viewProjection) {
+        m_visibleShapes.clear();
+        if (m_cullingMode == CullingMode::NONE) {
+            m_visibleShapes.assign(m_shape_list.begin(), m_shape_list.end());
+            m_renderStats.visible = (uint32_t)m_visibleShapes.size();
+            return;
+        }
+
+        Frustum frustum(viewProjection);
+        if (m_cullingMode == CullingMode::BVH) {
+            // 形状移动只做 refit，质量下降到一定程度再整体重建
+            m_shapeBVH.maintain();
+            m_shapeBVH.cull(frustum, m_visibleShapes);
+            m_renderStats.visible = (uint32_t)m_visibleShapes.size();
+            m_renderStats.culled = (uint32_t)(m_shape_list.size() - m_visibleShapes.size());
+            return;
+        }
+
+        // 包围球转为 SoA，供 SIMD 批量测试
+        size_t count = m_shape_list.size();
+        m_cullX.resize(count); m_cullY.resize(count); m_cullZ.resize(count);
+        m_cullRadius.resize(count); m_cullVisible.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const BoundingSphere& sphere = m_shape_list[i]->getWorldSphere();
+            m_cullX[i] = sphere.center.x;
+            m_cullY[i] = sphere.center.y;
+            m_cullZ[i] = sphere.center.z;
+            m_cullRadius[i] = sphere.radius;
+        }
+
+        frustum.testSpheres(m_cullX.data(), m_cullY.data(), m_cullZ.data(), m_cullRadius.data(),
+                            count, m_cullVisible.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            if (m_cullVisible[i] && frustum.testAABB(m_shape_list[i]->getWorldBounds())) {
+                m_visibleShapes.push_back(m_shape_list[i]);
+            }
+        }
+        m_renderStats.visible = (uint32_t)m_visibleShapes.size();
+        m_renderStats.culled = (uint32_t)(count - m_visibleShapes.size());
+    }
+
+    /**
+     * @brief 软件遮挡剔除：把可见的遮挡体光栅化为 Hi-Z，再测试其余可见形状
+     * @param viewProjection 本帧的视图投影矩阵
+     *
+     * 需在 cullShapes() 之后调用；遮挡体本身始终保留。
+     */
+    void cullOccluded(const glm::mat4& viewProjection) {
+        m_occlusionCuller.beginFrame(viewProjection);
+        for (auto& shape : m_visibleShapes) {
+            if (shape->isOccluder() && shape->getOccluderGeometry(m_occluderVertices, m_occluderIndices)) {
+                m_occlusionCuller.addOccluder(m_occluderVertices, m_occluderIndices, shape->getModelMatrix());
+            }
+        }
+        if (m_occlusionCuller.getTriangleCount() == 0) return;
+
+        m_occlusionCuller.rasterize();
+        m_occlusionCuller.buildHiZ();
+
+        size_t kept = 0;
+        for (auto& shape : m_visibleShapes) {
+            if (shape->isOccluder() || m_occlusionCuller.isVisible(shape->getWorldBounds())) {
+                m_visibleShapes[kept++] = shape;
+            }
+        }
+        m_renderStats.occluded = (uint32_t)(m_visibleShapes.size() - kept);
+        m_renderStats.visible = (uint32_t)kept;
+        m_visibleShapes.resize(kept);
+    }
+
+    /**
+     * @brief 为本帧可见的形状选择细节层级
+     *
+     * LOD 关闭时传入 +inf，所有形状回到最高细节。
+     */
+    void updateLOD() {
+        float pixelsPerUnit = std::numeric_limits<float>::infinity();
+        if (m_lodEnabled) {
+            // 距离为 1 处一个世界单位在屏幕上的像素高度
+            pixelsPerUnit = (float)m_height / (2.0f * std::tan(glm::radians(m_camera->getFov()) * 0.5f));
+        }
+        for (auto& shape : m_visibleShapes) {
+            m_renderStats.lodTrianglesSaved += shape->updateLOD(m_camera->Position, pixelsPerUnit);
+        }
+        // 实例化批次逐实例选择层级，同一层级的实例合并为一次绘制
+        for (auto& batch : m_batch_list) {
+            m_renderStats.lodTrianglesSaved += batch->updateLOD(m_camera->Position, pixelsPerUnit);
+        }
+    }
+
+    /**
+     * @brief 绘制所有形状与实例化批次
+     * @param shader 当前已激活的着色器
+     * @param view 视图矩阵（用于排序）
+     */
+    void drawScene(Shader* shader, const glm::mat4& view) {
+        // 绘制形状
+        if (m_useRenderQueue) {
+            // 排序后提交，只在状态改变时重新绑定
+            m_renderQueue.clear();
+            for (auto& shape : m_visibleShapes) {
+                m_renderQueue.push(shader, *shape, view);
+            }
+            m_renderQueue.submit(m_renderStats);
+        } else {
+            // 按插入顺序逐个绘制，每次都绑定并解绑 VAO
+            for (auto& shape : m_visibleShapes) {
+                shape->draw(*shader);
+                m_renderStats.drawCalls++;
+                m_renderStats.triangles += shape->getDrawCommand().getTriangleCount();
+                m_renderStats.vaoBinds += 2;
+                m_renderStats.modelUploads++;
+            }
+        }
+
+        // 实例化批次：每个批次的每个非空细节层级一次绘制调用
+        for (auto& batch : m_batch_list) {
+            if (batch->getInstanceCount() == 0) continue;
+            batch->draw(*shader);
+            uint32_t drawCalls = batch->getDrawCallCount();
+            m_renderStats.drawCalls += drawCalls;
+            m_renderStats.triangles += batch->getTriangleCount();
+            m_renderStats.vaoBinds += drawCalls + 1;
+        }
+    }
+
+    /**
+     * @brief 在控制台输出上一帧的渲染统计
+     */
+    void printRenderStats() const {
+        std::cout << "Frame time: " << std::fixed << std::setprecision(2) << m_renderStats.frameTime * 1000.0f << " ms"
+                  << std::defaultfloat
+                  << ", draw calls: " << m_renderStats.drawCalls
+                  << ", program binds: " << m_renderStats.programBinds
+                  << ", VAO binds: " << m_renderStats.vaoBinds
+                  << ", model uploads: " << m_renderStats.modelUploads
+                  << ", visible: " << m_renderStats.visible
+                  << ", culled: " << m_renderStats.culled
+                  << ", occluded: " << m_renderStats.occluded
+                  << ", triangles: " << m_renderStats.triangles
+                  << " (without LOD: " << m_renderStats.triangles + m_renderStats.lodTrianglesSaved << ")" << std::endl;
+        std::cout << "Stream buffers: " << (m_frameStream->isPersistent() ? "persistent" : "orphaning")
+                  << ", instance bytes this frame: " << m_instanceStream->getUsed()
+                  << ", fence stalls: " << m_frameStream->getStallCount() + m_instanceStream->getStallCount() << std::endl;
+
+        // 共享网格按 MeshCache 统计一次，不按形状累加
+        ShapeMemoryUsage memory;
+        for (const auto* shape : m_shape_list) memory += shape->getMemoryUsage();
+        std::cout << "Shape memory: " << m_shape_list.size() << " shapes, CPU " << memory.cpuBytes / 1024
+                  << " KB, own GPU buffers " << memory.gpuBytes / 1024
+                  << " KB, shared meshes " << MeshCache::getGpuBytes() / 1024 << " KB GPU / "
+                  << MeshCache::getCpuBytes() / 1024 << " KB CPU" << std::endl;
+    }
+
+    /**
+     * @brief 用 ImGui 绘制性能分析面板：帧时间曲线、绘制统计与各阶段计时
+     *
+     * 计时来自 Profiler 最近一个 GPU 结果已取回的帧（通常落后 1~2 帧），绘制统计来自本帧。
+     */
+    void drawProfilerOverlay() {
+        ImGui::SetCurrentContext(m_imguiContext);
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                       ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                                       ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+        ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Always);
+        ImGui::SetNextWindowBgAlpha(0.35f);
+        if (ImGui::Begin("Profiler", nullptr, flags)) {
+            const Profiler& profiler = *m_profiler;
+            ImGui::Text("CPU %.2f ms   GPU %.2f ms   %.0f FPS", profiler.getCpuFrameMs(), profiler.getGpuFrameMs(),
+                        ImGui::GetIO().Framerate);
+
+            // 两条曲线使用相同的纵轴范围，便于比较
+            float scale = 1.0f;
+            for (int i = 0; i < Profiler::HISTORY_SIZE; ++i) {
+                scale = std::max(scale, std::max(profiler.getCpuHistory()[i], profiler.getGpuHistory()[i]));
+            }
+            ImGui::PlotLines("CPU ms", profiler.getCpuHistory(), Profiler::HISTORY_SIZE, profiler.getHistoryOffset(),
+                             nullptr, 0.0f, scale * 1.1f, ImVec2(240.0f, 40.0f));
+            ImGui::PlotLines("GPU ms", profiler.getGpuHistory(), Profiler::HISTORY_SIZE, profiler.getHistoryOffset(),
+                             nullptr, 0.0f, scale * 1.1f, ImVec2(240.0f, 40.0f));
+
+            ImGui::Separator();
+            ImGui::Text("Draw calls %u   triangles %u", m_renderStats.drawCalls, m_renderStats.triangles);
+            ImGui::Text("Program binds %u   VAO binds %u", m_renderStats.programBinds, m_renderStats.vaoBinds);
+            ImGui::Text("Visible %u   culled %u   occluded %u", m_renderStats.visible, m_renderStats.culled,
+                        m_renderStats.occluded);
+
+            ImGui::Separator();
+            if (ImGui::BeginTable("zones", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+                ImGui::TableSetupColumn("Zone");
+                ImGui::TableSetupColumn("CPU ms");
+                ImGui::TableSetupColumn("GPU ms");
+                ImGui::TableHeadersRow();
+                for (const Profiler::ZoneResult& zone : profiler.getZones()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%*s%s", zone.depth * 2, "", zone.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", zone.cpuMs);
+                    ImGui::TableNextColumn();
+                    if (zone.gpuMs >= 0.0) {
+                        ImGui::Text("%.3f", zone.gpuMs);
+                    } else {
+                        ImGui::Text("-");
+                    }
+                }
+                ImGui::EndTable();
+            }
+            if (profiler.getDroppedFrames() > 0) {
+                ImGui::Text("Dropped GPU results: %llu", (unsigned long long)profiler.getDroppedFrames());
+            }
+        }
+        ImGui::End();
+
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+
     /**
      * @brief 向前循环切换渲染模式
      */
@@ -363,6 +1210,9 @@ private:
                 m_renderMode = RenderMode::FINAL_RESULT;
                 break;
             case RenderMode::FINAL_RESULT:
+                m_renderMode = m_gbufferShader ? RenderMode::DEFERRED_RESULT : RenderMode::VERTEX_SHADER_RESULT;
+                break;
+            case RenderMode::DEFERRED_RESULT:
                 m_renderMode = RenderMode::VERTEX_SHADER_RESULT;
                 break;
         }
@@ -375,7 +1225,7 @@ private:
     void cycleRenderModeBackward() {
         switch (m_renderMode) {
             case RenderMode::VERTEX_SHADER_RESULT:
-                m_renderMode = RenderMode::FINAL_RESULT;
+                m_renderMode = m_gbufferShader ? RenderMode::DEFERRED_RESULT : RenderMode::FINAL_RESULT;
                 break;
             case RenderMode::RASTERIZED_RESULT:
                 m_renderMode = RenderMode::VERTEX_SHADER_RESULT;
@@ -386,6 +1236,9 @@ private:
             case RenderMode::FINAL_RESULT:
                 m_renderMode = RenderMode::FRAGMENT_SHADER_RESULT;
                 break;
+            case RenderMode::DEFERRED_RESULT:
+                m_renderMode = RenderMode::FINAL_RESULT;
+                break;
         }
         std::cout << "Render mode: " << static_cast<int>(m_renderMode) << std::endl;
     }
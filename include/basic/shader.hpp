@@ -1,8 +1,22 @@
 #pragma once
 #include <GL/glew.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
+/**
+ * @brief 预解析的 uniform 位置句柄
+ *
+ * 由 Shader::getUniform() 在初始化阶段获取一次，之后每帧直接使用，避免字符串构造与位置查询。
+ * 位置为 -1 表示着色器中不存在该 uniform（与 OpenGL 一致，设置时会被忽略）。
+ */
+struct UniformHandle {
+    GLint location = -1;
+
+    bool valid() const { return location >= 0; }
+};
+
 /**
  * @brief 简单的着色器封装：从顶点/片段着色器文件构建 program，并提供常用 uniform 上传方法
  */
@@ -25,12 +39,33 @@ public:
      */
     void use();
 
+    /**
+     * @brief 获取 uniform 句柄
+     * @param name uniform 名称（数组元素可写作 "name[i]"）
+     * @return 句柄；不存在时 location 为 -1
+     *
+     * 位置在链接后一次性缓存到按哈希排序的扁平表中，查询不分配内存、不调用 OpenGL。
+     */
+    UniformHandle getUniform(const char* name) const;
+
+    /**
+     * @brief 把 uniform block 绑定到指定绑定点
+     * @param blockName block 名称
+     * @param binding 绑定点（见 UniformBlockBinding）
+     * @return 着色器中存在该 block 时返回 true
+     *
+     * 构造时已自动绑定 uniform_buffer.hpp 中约定的 block，一般无需手动调用。
+     */
+    bool bindUniformBlock(const char* blockName, GLuint binding);
+
     /**
      * @brief 设置 int 类型 uniform
      * @param name uniform 名称
      * @param value 要设置的整数值
      */
     void setInt(const std::string &name, int value) const;
+    void setInt(const char* name, int value) const;
+    void setInt(UniformHandle handle, int value) const;
 
     /**
      * @brief 设置 float 类型 uniform
@@ -38,6 +73,8 @@ public:
      * @param value 要设置的浮点值
      */
     void setFloat(const std::string &name, float value) const;
+    void setFloat(const char* name, float value) const;
+    void setFloat(UniformHandle handle, float value) const;
 
     /**
      * @brief 设置 vec3 类型 uniform
@@ -45,6 +82,8 @@ public:
      * @param value 三维向量 (x,y,z)
      */
     void setVec3(const std::string &name, const glm::vec3 &value) const;
+    void setVec3(const char* name, const glm::vec3 &value) const;
+    void setVec3(UniformHandle handle, const glm::vec3 &value) const;
 
     /**
      * @brief 设置 mat4 类型 uniform
@@ -52,8 +91,34 @@ public:
      * @param mat 4x4 矩阵（按列主序传递给 OpenGL）
      */
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    void setMat4(const char* name, const glm::mat4 &mat) const;
+    void setMat4(UniformHandle handle, const glm::mat4 &mat) const;
+
+    /**
+     * @brief 设置 mat3 类型 uniform
+     * @param name uniform 名称
+     * @param mat 3x3 矩阵（按列主序传递给 OpenGL）
+     */
+    void setMat3(const std::string &name, const glm::mat3 &mat) const;
+    void setMat3(const char* name, const glm::mat3 &mat) const;
+    void setMat3(UniformHandle handle, const glm::mat3 &mat) const;
 
 private:
+    // uniform 位置表的一项
+    struct UniformEntry {
+        uint32_t hash;      // 名称的 FNV-1a 哈希
+        GLint location;     // uniform 位置
+        std::string name;   // 名称（仅在哈希冲突时比较）
+    };
+
+    // 按哈希排序的 uniform 位置表，链接后构建
+    std::vector<UniformEntry> m_uniforms;
+
+    /**
+     * @brief 枚举程序中所有活动 uniform，缓存其位置
+     */
+    void cacheUniformLocations();
+
     /**
      * @brief 编译或链接出错时打印详细信息
      * @param shader 着色器/程序 ID
@@ -0,0 +1,95 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+
+/**
+ * @brief 每帧变化数据的流式环形缓冲
+ *
+ * 支持 ARB_buffer_storage（或 GL 4.4）时：缓冲一次性持久映射（coherent），
+ * 划分为 REGION_COUNT 个区域轮流使用；每帧结束时在当前区域放置 fence，
+ * 再次轮到该区域时等待 fence，保证 GPU 已读完旧数据。写入只是 memcpy，没有驱动同步。
+ *
+ * 不支持时（GL 3.3）退化为孤立（orphaning）：每帧开始时 glBufferData(nullptr)
+ * 让驱动分配新存储，之后以 GL_MAP_UNSYNCHRONIZED_BIT 映射写入。
+ *
+ * 每帧：beginFrame() → 若干次 write()/map() → 绘制 → endFrame()。
+ * 写入的数据只在本帧有效。
+ */
+class StreamBuffer {
+public:
+    static constexpr int REGION_COUNT = 3;   // 三重缓冲
+
+    /**
+     * @brief 创建流式缓冲
+     * @param target 缓冲目标（GL_ARRAY_BUFFER、GL_UNIFORM_BUFFER 等；不要用 GL_ELEMENT_ARRAY_BUFFER，映射时会改动当前 VAO）
+     * @param regionSize 每帧可写入的字节数
+     */
+    StreamBuffer(GLenum target, GLsizeiptr regionSize);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief 切换到下一个区域（必要时等待 GPU 读完该区域）
+     */
+    void beginFrame();
+
+    /**
+     * @brief 本帧的绘制命令已全部提交，在当前区域放置 fence
+     */
+    void endFrame();
+
+    /**
+     * @brief 在本帧区域中分配并映射一段空间
+     * @param size 字节数
+     * @param alignment 偏移对齐（UBO 需使用 getUniformAlignment()）
+     * @param offset 输出：在缓冲中的偏移
+     * @return 写指针；本帧空间不足时返回 nullptr。写完后必须调用 unmap()
+     */
+    void* map(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+    void unmap();
+
+    /**
+     * @brief 写入数据
+     * @return 在缓冲中的偏移；本帧空间不足时返回 -1
+     */
+    GLintptr write(const void* data, GLsizeiptr size, GLsizeiptr alignment = 16);
+
+    GLuint getID() const { return ID; }
+    GLenum getTarget() const { return m_target; }
+    bool isPersistent() const { return m_persistent != nullptr; }
+    GLsizeiptr getRegionSize() const { return m_regionSize; }
+    GLsizeiptr getUsed() const { return m_cursor; }
+
+    /**
+     * @brief 因 GPU 尚未读完而等待 fence 的次数（持续增长说明区域太少或 GPU 落后太多）
+     */
+    uint32_t getStallCount() const { return m_stalls; }
+
+    /**
+     * @brief 当前上下文是否支持持久映射
+     */
+    static bool isPersistentMappingSupported();
+
+    /**
+     * @brief GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+     */
+    static GLsizeiptr getUniformAlignment();
+
+private:
+    /**
+     * @brief 在本帧区域中按对齐保留空间，返回区域内偏移；不足返回 -1
+     */
+    GLintptr reserve(GLsizeiptr size, GLsizeiptr alignment);
+
+    GLuint ID = 0;
+    GLenum m_target;
+    GLsizeiptr m_regionSize;
+    GLsizeiptr m_cursor = 0;       // 本帧区域内已使用的字节数
+    int m_region = 0;              // 当前区域（仅持久映射）
+    uint8_t* m_persistent = nullptr;  // 持久映射的起始地址；为空表示孤立模式
+    bool m_mapped = false;         // 孤立模式下是否有未 unmap 的映射
+    GLsync m_fences[REGION_COUNT] = {};
+    uint32_t m_stalls = 0;
+};
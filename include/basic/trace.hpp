@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief CPU 时间线记录，导出为 Chrome Trace Event JSON（chrome://tracing、ui.perfetto.dev 可直接打开）
+ *
+ * 每个线程第一次记录时分配自己的缓冲：由固定大小的块组成的单向链表，只有本线程追加，
+ * 追加时不加锁，导出线程可以同时读取已提交的部分。块数达到上限后回收最早的块（环形），
+ * 保留的是最近的事件，被覆盖的事件数由 getDroppedCount() 给出。线程退出后缓冲留给之后新建的线程复用，
+ * 因此每帧新建工作线程也不会无限增加缓冲。
+ *
+ * 一般不直接调用，而是使用下面的 TRACE_* 宏；CMake 选项 ENABLE_TRACING 关闭时宏展开为空，不产生任何开销。
+ */
+class Trace {
+public:
+    static constexpr size_t CHUNK_EVENTS = 16384;       // 每块的事件数
+    static constexpr size_t MAX_CHUNKS_PER_THREAD = 256;  // 每个线程最多保留约 400 万个事件，之后覆盖最早的
+
+    /**
+     * @brief 单调时钟，单位纳秒
+     */
+    static uint64_t now();
+
+    /**
+     * @brief 记录当前线程上一段已结束的区段
+     * @param name 区段名，必须在导出前一直有效（字符串字面量或 __func__）
+     */
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    /**
+     * @brief 设置当前线程在时间线上显示的名字（同样需要长期有效）
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief 把目前保留的所有事件写入文件（可在运行中随时调用）；被覆盖的事件数写在 otherData.overwrittenEvents
+     * @return 写入成功返回 true
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief 程序退出时自动写入该文件（空字符串取消）
+     */
+    static void setOutputOnExit(const std::string& path);
+
+    /**
+     * @brief 当前保留的事件数
+     */
+    static size_t getEventCount();
+
+    /**
+     * @brief 缓冲写满后被覆盖（丢失）的最早事件数
+     */
+    static uint64_t getDroppedCount();
+};
+
+/**
+ * @brief RAII 区段：构造时记下开始时间，析构时记录
+ */
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : m_name(name), m_start(Trace::now()) {}
+    ~TraceZone() { Trace::record(m_name, m_start, Trace::now()); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_start;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#if defined(ENGINE_TRACING)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone_, __LINE__)(name)
+#define TRACE_FUNCTION() TRACE_ZONE(__func__)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_FUNCTION() ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
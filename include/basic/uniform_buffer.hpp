@@ -0,0 +1,60 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/**
+ * @brief 固定的 uniform block 绑定点
+ *
+ * 着色器链接后由 Shader 按 block 名称自动绑定到这些绑定点，
+ * 因此任意数量的着色器程序都能读取同一份缓冲而无需重复上传。
+ */
+enum UniformBlockBinding : GLuint {
+    FRAME_DATA_BINDING = 0,     // FrameData：摄像机矩阵、位置与时间
+    LIGHT_DATA_BINDING = 1      // LightData：全部光源
+};
+
+/**
+ * @brief 每帧数据（std140 布局，与着色器中的 FrameData block 一一对应）
+ */
+struct FrameData {
+    glm::mat4 view;             // 视图矩阵
+    glm::mat4 projection;       // 投影矩阵
+    glm::mat4 viewProjection;   // projection * view
+    glm::vec4 cameraPosition;   // xyz：摄像机世界坐标，w 未使用
+    glm::vec4 time;             // x：程序运行时间（秒），y：帧间隔（秒），zw 未使用
+};
+static_assert(sizeof(FrameData) == 3 * 64 + 2 * 16, "FrameData must match the std140 layout");
+
+/**
+ * @brief uniform 缓冲对象（UBO）封装，创建后绑定到固定绑定点
+ */
+class UniformBuffer {
+public:
+    /**
+     * @brief 创建 UBO 并绑定到绑定点
+     * @param size 缓冲大小（字节）
+     * @param binding 绑定点
+     */
+    UniformBuffer(GLsizeiptr size, GLuint binding);
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    /**
+     * @brief 更新缓冲内容
+     * @param data 数据指针
+     * @param size 数据大小（字节）
+     * @param offset 写入偏移（字节）
+     */
+    void update(const void* data, GLsizeiptr size, GLintptr offset = 0);
+
+    GLuint getID() const { return ID; }
+    GLuint getBinding() const { return m_binding; }
+    GLsizeiptr getSize() const { return m_size; }
+
+private:
+    GLuint ID = 0;
+    GLuint m_binding;
+    GLsizeiptr m_size;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 常驻工作线程池
+ *
+ * 线程在构造时创建、析构时结束，parallelFor() 只唤醒已有线程，不再每次创建/回收线程。
+ * 调用线程同样参与执行，各线程从原子计数器领取任务下标，因此任务之间应当互不依赖。
+ *
+ * 同一时刻只执行一批任务（多个线程同时调用 parallelFor 会依次执行）；
+ * 在任务内部再次调用 parallelFor 时直接在当前线程串行执行，避免死锁。不依赖 OpenGL。
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief 构造
+     * @param threadCount 参与执行的线程总数（含调用线程）；0 表示使用硬件线程数
+     */
+    explicit WorkerPool(unsigned threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief 对 [0, taskCount) 的每个下标调用一次 task，全部完成后返回
+     * @param taskCount 任务数
+     * @param task 任务函数，参数为任务下标
+     */
+    void parallelFor(unsigned taskCount, const std::function<void(unsigned)>& task);
+
+    /**
+     * @brief 参与执行的线程总数（含调用线程）
+     */
+    unsigned getThreadCount() const { return (unsigned)m_threads.size() + 1; }
+
+    /**
+     * @brief 进程内共享的线程池（第一次使用时创建），供分簇光照、遮挡剔除等每帧任务复用
+     */
+    static WorkerPool& shared();
+
+private:
+    void workerLoop();
+
+    /**
+     * @brief 领取并执行当前批次的任务，返回本线程完成的任务数
+     */
+    unsigned runTasks(const std::function<void(unsigned)>& task, unsigned taskCount);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_submitMutex;           // 串行化并发的 parallelFor 调用
+
+    std::mutex m_mutex;                 // 保护以下批次状态
+    std::condition_variable m_wake;     // 新批次或退出
+    std::condition_variable m_done;     // 批次完成或工作线程离开批次
+    uint64_t m_generation = 0;          // 批次序号
+    const std::function<void(unsigned)>* m_task = nullptr;
+    unsigned m_taskCount = 0;
+    unsigned m_finished = 0;            // 已完成的任务数
+    unsigned m_busy = 0;                // 正在领取当前批次任务的工作线程数
+    bool m_stop = false;
+
+    std::atomic<unsigned> m_next{ 0 };  // 下一个待领取的任务下标
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <glm/glm.hpp>
+#include "light.hpp"
+#include "light_cluster.hpp"
+#include "shader.hpp"
+
+// 分簇光照使用的纹理单元（纹理缓冲对象）
+enum ClusterTextureUnit : GLuint {
+    CLUSTER_LIGHTS_UNIT = 4,    // 全部光源，每个光源 6 个 RGBA32F 纹素（与 GPULight 一致）
+    CLUSTER_RANGES_UNIT = 5,    // 每个簇的 (offset, count)，RG32UI
+    CLUSTER_INDICES_UNIT = 6    // 光源索引，R32UI
+};
+
+/**
+ * @brief 分簇光照的 GPU 数据
+ *
+ * 每帧：在 CPU 上用 LightClusterer 把光源分配到簇，然后把光源、簇范围与索引表
+ * 上传到三个纹理缓冲对象（GL 3.3 core 无 SSBO）。光源数量不受 UBO 大小限制。
+ */
+class ClusterLightBuffer {
+public:
+    ClusterLightBuffer(int tilesX = 16, int tilesY = 9, int slicesZ = 24);
+    ~ClusterLightBuffer();
+
+    ClusterLightBuffer(const ClusterLightBuffer&) = delete;
+    ClusterLightBuffer& operator=(const ClusterLightBuffer&) = delete;
+
+    /**
+     * @brief 分配光源并上传
+     * @param lights 光源列表
+     * @param view 视图矩阵
+     * @param fovY 垂直视场角（弧度）
+     * @param aspect 宽高比
+     * @param nearPlane 近裁剪面距离
+     * @param farPlane 远裁剪面距离
+     */
+    void update(const std::vector<Light*>& lights, const glm::mat4& view,
+                float fovY, float aspect, float nearPlane, float farPlane);
+
+    /**
+     * @brief 绑定纹理缓冲并设置着色器中的分簇参数
+     * @param shader 当前已激活的着色器
+     * @param viewportWidth 视口宽度（像素）
+     * @param viewportHeight 视口高度（像素）
+     */
+    void bind(const Shader& shader, int viewportWidth, int viewportHeight) const;
+
+    const LightClusterer& getClusterer() const { return m_clusterer; }
+
+private:
+    // 纹理缓冲对象：缓冲 + 引用它的纹理
+    struct TextureBuffer {
+        GLuint buffer = 0;
+        GLuint texture = 0;
+        GLsizeiptr capacity = 0;
+    };
+
+    void createTextureBuffer(TextureBuffer& tbo, GLenum format);
+    void uploadTextureBuffer(TextureBuffer& tbo, const void* data, GLsizeiptr size);
+
+    LightClusterer m_clusterer;
+    TextureBuffer m_lights, m_ranges, m_indices;
+
+    // 每帧复用的临时数据
+    std::vector<GPULight> m_gpuLights;
+    std::vector<glm::vec4> m_viewSpheres;
+};
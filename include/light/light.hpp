@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
+#include "shader.hpp"
 
 // 光源类型枚举
 enum LightType {
@@ -11,6 +12,38 @@ enum LightType {
     SPOT_LIGHT
 };
 
+/**
+ * @brief 单个光源的 GPU 数据（std140 布局，与着色器中的 Light 结构一致）
+ */
+struct GPULight {
+    glm::vec4 positionType;         // xyz：位置，w：类型（LightType）
+    glm::vec4 directionCutOff;      // xyz：方向，w：内切光角余弦
+    glm::vec4 ambientOuterCutOff;   // xyz：环境光，w：外切光角余弦
+    glm::vec4 diffuse;              // xyz：漫反射，w 未使用
+    glm::vec4 specular;             // xyz：镜面反射，w 未使用
+    glm::vec4 attenuation;          // x：常数项，y：一次项，z：二次项，w：影响半径
+};
+static_assert(sizeof(GPULight) == 6 * 16, "GPULight must match the std140 layout");
+
+/**
+ * @brief 光源结构体各字段的 uniform 句柄
+ *
+ * 通过 Light::resolveUniforms() 在初始化阶段解析一次，之后每帧复用。
+ */
+struct LightUniforms {
+    UniformHandle position;
+    UniformHandle direction;
+    UniformHandle ambient;
+    UniformHandle diffuse;
+    UniformHandle specular;
+    UniformHandle constant;
+    UniformHandle linear;
+    UniformHandle quadratic;
+    UniformHandle cutOff;
+    UniformHandle outerCutOff;
+    UniformHandle type;
+};
+
 /**
  * @brief 光源基类
  */
@@ -52,6 +85,33 @@ public:
      * @param name 光源名称（例如"light[0]"或"dirLight"）
      */
     virtual void setUniform(unsigned int shaderProgram, const std::string& name) const;
+
+    /**
+     * @brief 使用预解析的句柄设置光源 uniform（不分配内存、不查询位置）
+     * @param shader 当前已激活的着色器
+     * @param handles 由 resolveUniforms() 得到的句柄
+     */
+    virtual void setUniform(const Shader& shader, const LightUniforms& handles) const;
+
+    /**
+     * @brief 解析光源结构体各字段的 uniform 句柄
+     * @param shader 着色器
+     * @param name 光源名称（例如"light[0]"或"dirLight"）
+     * @return 句柄集合
+     */
+    static LightUniforms resolveUniforms(const Shader& shader, const char* name);
+
+    /**
+     * @brief 打包为 GPU 光源数据（用于 LightBuffer）
+     * @return std140 布局的光源数据
+     */
+    GPULight toGPU() const;
+
+    /**
+     * @brief 光源影响半径（衰减到 1/256 以下的距离），用于分簇光照
+     * @return 半径；方向光返回 +inf
+     */
+    float getRange() const;
     
     /**
      * @brief 设置光源类型为点光源
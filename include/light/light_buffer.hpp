@@ -0,0 +1,43 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <glm/glm.hpp>
+#include "light.hpp"
+#include "uniform_buffer.hpp"
+
+// 单次上传的最大光源数（需与 fragment.glsl 中的 MAX_LIGHTS 一致）
+constexpr int MAX_LIGHTS = 128;
+
+/**
+ * @brief LightData uniform block 的内容（std140）
+ */
+struct LightBlock {
+    glm::ivec4 lightCount;          // x：有效光源数
+    GPULight lights[MAX_LIGHTS];
+};
+
+/**
+ * @brief 光源缓冲：把所有光源打包进一个 UBO，每帧一次上传
+ *
+ * 着色器通过 LightData block（绑定点 LIGHT_DATA_BINDING）读取，
+ * 光源数量的增加不会带来额外的 uniform 调用或程序切换。
+ */
+class LightBuffer {
+public:
+    LightBuffer();
+
+    /**
+     * @brief 打包并上传光源（超出 MAX_LIGHTS 的部分被忽略）
+     * @param lights 光源列表
+     */
+    void upload(const std::vector<Light*>& lights);
+
+    /**
+     * @brief 上一次上传的光源数
+     */
+    int getLightCount() const { return m_block.lightCount.x; }
+
+private:
+    UniformBuffer m_ubo;
+    LightBlock m_block;
+};
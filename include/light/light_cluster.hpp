@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class WorkerPool;
+
+/**
+ * @brief 根据衰减参数计算光源的影响半径
+ * @param constant 常数衰减因子
+ * @param linear 一次衰减因子
+ * @param quadratic 二次衰减因子
+ * @param intensity 光源最大强度（颜色分量的最大值）
+ * @param threshold 视为无贡献的强度阈值（默认 1/256，低于 8 位颜色精度）
+ * @return 半径；无衰减时返回 +inf
+ *
+ * 求解 intensity / (constant + linear*d + quadratic*d^2) = threshold 中的 d。
+ */
+float computeLightRange(float constant, float linear, float quadratic,
+                        float intensity, float threshold = 1.0f / 256.0f);
+
+/**
+ * @brief 分簇光源分配器（Clustered Forward+ 的 CPU 部分）
+ *
+ * 把视锥划分为 tilesX × tilesY × slicesZ 个簇（深度方向按指数划分），
+ * 对每个簇求出与之相交的光源列表。实现不依赖 OpenGL，可单独做基准测试。
+ *
+ * 数据布局面向 SIMD：簇包围盒与光源包围球均以 SoA 数组存放，
+ * 内层循环对连续的光源做无分支的球-盒距离测试，便于编译器自动向量化；
+ * 深度切片在常驻线程池的多个线程间划分，各分段的临时数组跨帧复用。
+ */
+class LightClusterer {
+public:
+    /**
+     * @brief 构造
+     * @param pool 执行分配的线程池；为空时使用 WorkerPool::shared()
+     */
+    LightClusterer(int tilesX = 16, int tilesY = 9, int slicesZ = 24, WorkerPool* pool = nullptr);
+
+    /**
+     * @brief 设置透视投影参数，参数变化时重建簇包围盒
+     * @param fovY 垂直视场角（弧度）
+     * @param aspect 宽高比
+     * @param nearPlane 近裁剪面距离
+     * @param farPlane 远裁剪面距离
+     */
+    void setProjection(float fovY, float aspect, float nearPlane, float farPlane);
+
+    /**
+     * @brief 把光源分配到簇
+     * @param viewSpaceLights 视空间中的光源包围球（xyz：球心，w：半径）
+     * @param threadCount 切片划分的份数；0 表示使用线程池的线程数
+     */
+    void assign(const std::vector<glm::vec4>& viewSpaceLights, unsigned threadCount = 0);
+
+    /**
+     * @brief 每个簇在索引表中的范围，按 (offset, count) 成对存放
+     *
+     * 簇编号 = x + tilesX * (y + tilesY * z)。
+     */
+    const std::vector<uint32_t>& getClusterRanges() const { return m_ranges; }
+
+    /**
+     * @brief 所有簇的光源索引，按簇连续存放
+     */
+    const std::vector<uint32_t>& getLightIndices() const { return m_indices; }
+
+    int getTilesX() const { return m_tilesX; }
+    int getTilesY() const { return m_tilesY; }
+    int getSlicesZ() const { return m_slicesZ; }
+    int getClusterCount() const { return m_tilesX * m_tilesY * m_slicesZ; }
+
+    /**
+     * @brief 着色器由视空间深度求切片：slice = floor(log(depth) * scale + bias)
+     */
+    float getSliceScale() const { return m_sliceScale; }
+    float getSliceBias() const { return m_sliceBias; }
+
+private:
+    /**
+     * @brief 一份切片范围的临时数据，跨帧复用以免每次分配
+     */
+    struct SliceScratch {
+        std::vector<uint32_t> indices;      // 本段的光源索引表
+        std::vector<uint32_t> candidates;   // 与当前切片深度范围相交的光源
+        std::vector<float> cx, cy, cz, cr2; // 候选光源（紧凑的 SoA）
+        std::vector<uint8_t> hit;
+    };
+
+    /**
+     * @brief 处理 [sliceBegin, sliceEnd) 范围的深度切片
+     */
+    void assignSlices(int sliceBegin, int sliceEnd, SliceScratch& scratch);
+
+    int m_tilesX, m_tilesY, m_slicesZ;
+
+    // 当前投影参数
+    float m_fovY = 0.0f, m_aspect = 0.0f, m_near = 0.0f, m_far = 0.0f;
+    float m_sliceScale = 0.0f, m_sliceBias = 0.0f;
+
+    // 视空间中的簇包围盒（SoA）
+    std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+
+    // 本次分配的光源包围球（SoA）
+    std::vector<float> m_lightX, m_lightY, m_lightZ, m_lightR2;
+
+    // 输出
+    std::vector<uint32_t> m_ranges;
+    std::vector<uint32_t> m_indices;
+
+    WorkerPool* m_pool;
+    std::vector<SliceScratch> m_scratch;    // 每份切片范围一个
+};
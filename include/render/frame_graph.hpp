@@ -0,0 +1,230 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Profiler;
+
+/**
+ * @brief 瞬态纹理的描述
+ *
+ * 描述相同且生命周期不重叠的瞬态纹理会共用同一张物理纹理（别名）。
+ */
+struct FrameTextureDesc {
+    int width = 0;
+    int height = 0;
+    GLenum internalFormat = GL_RGBA8;
+
+    bool operator==(const FrameTextureDesc& other) const {
+        return width == other.width && height == other.height && internalFormat == other.internalFormat;
+    }
+
+    /**
+     * @brief 是否为深度（或深度模板）格式，决定挂到哪个附件点
+     */
+    bool isDepth() const;
+
+    /**
+     * @brief 估算的显存字节数
+     */
+    size_t getBytes() const;
+};
+
+/**
+ * @brief 首次写入资源时如何处理其旧内容
+ */
+enum class LoadOp {
+    CLEAR = 0,      // 清除（颜色清为 0 / 背景色，深度清为 1）
+    DONT_CARE       // 本通道会覆盖全部像素，不必清除
+};
+
+/**
+ * @brief 帧图：每帧声明渲染通道及其读写的附件，由帧图负责剔除、排序与瞬态纹理的分配
+ *
+ * 每帧：reset() → 声明资源与通道 → compile() → execute()。
+ *  - 剔除：从导入资源（默认帧缓冲）与带副作用的通道反向引用计数，结果无人使用的通道不执行
+ *  - 排序：按读写依赖拓扑排序，无依赖约束时保持声明顺序
+ *  - 别名：按执行顺序计算瞬态纹理的生命周期，描述相同且生命周期不重叠的纹理共用物理纹理；
+ *          物理纹理与 FBO 跨帧复用，本帧未用到的物理纹理被释放
+ *  - 清除：只在资源第一次被写入且 LoadOp 为 CLEAR 时清除，之后的写入保留已有内容
+ */
+class FrameGraph {
+public:
+    using Resource = uint32_t;
+    static constexpr Resource INVALID_RESOURCE = UINT32_MAX;
+
+    /**
+     * @brief 通道的执行函数；执行时帧缓冲与视口已按通道写入的附件设置好
+     */
+    using ExecuteFn = std::function<void(const FrameGraph&)>;
+
+    /**
+     * @brief 声明通道读写关系的辅助对象（由 addPass 返回）
+     */
+    class PassBuilder {
+    public:
+        /**
+         * @brief 通道读取该资源（作为纹理采样）
+         */
+        PassBuilder& read(Resource resource);
+
+        /**
+         * @brief 通道写入该资源（作为附件）。颜色附件按调用顺序对应 GL_COLOR_ATTACHMENT0..n
+         * @param load 该资源在本帧第一次被写入时的处理方式
+         */
+        PassBuilder& write(Resource resource, LoadOp load = LoadOp::CLEAR);
+
+        /**
+         * @brief 通道有帧图之外的副作用（例如回读），即使输出无人使用也不剔除
+         */
+        PassBuilder& setSideEffect();
+
+    private:
+        friend class FrameGraph;
+        PassBuilder(FrameGraph& graph, size_t pass) : m_graph(graph), m_pass(pass) {}
+
+        FrameGraph& m_graph;
+        size_t m_pass;
+    };
+
+    /**
+     * @brief 一帧编译后的统计
+     */
+    struct Stats {
+        size_t passCount = 0;           // 声明的通道数
+        size_t culledPasses = 0;        // 被剔除的通道数
+        size_t transientTextures = 0;   // 实际使用的瞬态纹理数
+        size_t physicalTextures = 0;    // 分配的物理纹理数
+        size_t transientBytes = 0;      // 不做别名时所需的显存
+        size_t physicalBytes = 0;       // 实际分配的显存
+    };
+
+    FrameGraph();
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    /**
+     * @brief 开始声明新的一帧（清空上一帧的通道与资源，物理纹理与 FBO 保留复用）
+     */
+    void reset();
+
+    /**
+     * @brief 声明瞬态纹理（只在本帧内有效）
+     */
+    Resource createTexture(const std::string& name, const FrameTextureDesc& desc);
+
+    /**
+     * @brief 导入外部帧缓冲（颜色 + 深度）。导入资源不会被别名，写入它的通道不会被剔除
+     * @param framebuffer FBO 名称（0 为默认帧缓冲）
+     * @param clearColor LoadOp::CLEAR 时使用的背景色
+     */
+    Resource importFramebuffer(const std::string& name, GLuint framebuffer, int width, int height,
+                               const glm::vec4& clearColor = glm::vec4(0.0f));
+
+    /**
+     * @brief 导入默认帧缓冲
+     */
+    Resource importBackbuffer(const std::string& name, int width, int height,
+                              const glm::vec4& clearColor = glm::vec4(0.0f)) {
+        return importFramebuffer(name, 0, width, height, clearColor);
+    }
+
+    /**
+     * @brief 声明渲染通道
+     * @param name 通道名（用于调试输出）
+     * @param execute 执行函数
+     */
+    PassBuilder addPass(const std::string& name, ExecuteFn execute);
+
+    /**
+     * @brief 剔除无用通道、排序并分配瞬态纹理。依赖成环或同一通道混写导入的帧缓冲与纹理时抛出 std::logic_error
+     */
+    void compile();
+
+    /**
+     * @brief 按编译结果依次执行通道，结束后恢复默认帧缓冲
+     * @param profiler 非空时每个通道计为一个区段（以通道名命名）
+     */
+    void execute(Profiler* profiler = nullptr);
+
+    /**
+     * @brief 资源当前对应的纹理对象（compile() 之后有效；导入的帧缓冲为 0）
+     */
+    GLuint getTexture(Resource resource) const;
+
+    /**
+     * @brief 把资源的纹理绑定到指定纹理单元
+     */
+    void bindTexture(Resource resource, GLuint unit) const;
+
+    /**
+     * @brief 绘制覆盖整个视口的三角形（顶点由 gl_VertexID 生成），供全屏通道使用
+     */
+    void drawFullscreenTriangle() const;
+
+    const Stats& getStats() const { return m_stats; }
+
+    /**
+     * @brief 按执行顺序输出通道、被剔除的通道与瞬态纹理到物理纹理的映射
+     */
+    void print(std::ostream& out) const;
+
+private:
+    struct ResourceNode {
+        std::string name;
+        FrameTextureDesc desc;
+        bool imported = false;
+        GLuint framebuffer = 0;         // 导入的 FBO
+        glm::vec4 clearColor = glm::vec4(0.0f);
+        std::vector<size_t> writers;    // 按声明顺序
+        std::vector<size_t> readers;
+        int physical = -1;              // 物理纹理下标（导入资源为 -1）
+        size_t firstWriter = SIZE_MAX;  // 执行顺序中第一个写入它的通道（在此清除）
+        int firstUse = -1, lastUse = -1;  // 在执行顺序中的位置
+    };
+
+    struct PassNode {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Resource> reads;
+        std::vector<std::pair<Resource, LoadOp>> writes;
+        bool sideEffect = false;
+        bool culled = false;
+    };
+
+    struct PhysicalTexture {
+        GLuint id = 0;
+        FrameTextureDesc desc;
+        int busyUntil = -1;     // 本帧占用到执行顺序中的哪个位置
+        bool used = false;      // 本帧是否被使用
+    };
+
+    void cullPasses();
+    void sortPasses();
+    void assignPhysicalTextures();
+    void releaseUnusedTextures();
+
+    /**
+     * @brief 获取（必要时创建）挂接这些附件的 FBO
+     */
+    GLuint getFramebuffer(const std::vector<GLuint>& colors, GLuint depth, bool depthStencil);
+
+    std::vector<ResourceNode> m_resources;
+    std::vector<PassNode> m_passes;
+    std::vector<size_t> m_order;                // 执行顺序（只含未被剔除的通道）
+
+    std::vector<PhysicalTexture> m_textures;    // 跨帧复用的物理纹理
+    std::map<std::vector<GLuint>, GLuint> m_framebuffers;  // 附件纹理列表（最后一项为深度）-> FBO
+    GLuint m_emptyVAO = 0;  // core profile 下绘制必须绑定一个 VAO
+
+    Stats m_stats;
+    bool m_compiled = false;
+};
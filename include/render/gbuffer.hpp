@@ -0,0 +1,45 @@
+#pragma once
+#include <GL/glew.h>
+#include "frame_graph.hpp"
+
+// G-buffer 纹理在光照解析阶段使用的纹理单元
+enum GBufferTextureUnit : GLuint {
+    GBUFFER_ALBEDO_UNIT = 0,    // 反照率 + 镜面强度
+    GBUFFER_NORMAL_UNIT = 1,    // 法线 + 光泽度
+    GBUFFER_DEPTH_UNIT = 2      // 深度（用于重建世界坐标）
+};
+
+/**
+ * @brief 延迟着色使用的紧凑 G-buffer（每像素 12 字节），以帧图瞬态纹理的形式声明
+ *
+ *  - RT0  RGBA8     ：rgb 反照率，a 镜面强度
+ *  - RT1  RGB10_A2  ：rg 八面体编码法线，b 光泽度 / 256
+ *  - 深度 DEPTH24   ：不单独存储位置，解析时由深度与逆视图投影矩阵重建
+ *
+ * 纹理的分配、别名与清除由 FrameGraph 负责；几何通道按 albedo、normal、depth 的顺序写入。
+ */
+struct GBuffer {
+    FrameGraph::Resource albedo = FrameGraph::INVALID_RESOURCE;
+    FrameGraph::Resource normal = FrameGraph::INVALID_RESOURCE;
+    FrameGraph::Resource depth = FrameGraph::INVALID_RESOURCE;
+
+    /**
+     * @brief 在帧图中声明本帧的 G-buffer 纹理
+     */
+    static GBuffer declare(FrameGraph& graph, int width, int height);
+
+    /**
+     * @brief 几何通道写入全部附件（颜色附件顺序即 RT0、RT1）
+     */
+    void declareWrites(FrameGraph::PassBuilder& pass) const;
+
+    /**
+     * @brief 光照通道读取全部附件
+     */
+    void declareReads(FrameGraph::PassBuilder& pass) const;
+
+    /**
+     * @brief 把 G-buffer 纹理绑定到 GBufferTextureUnit 中约定的纹理单元（在通道执行函数中调用）
+     */
+    void bindTextures(const FrameGraph& graph) const;
+};
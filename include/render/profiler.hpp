@@ -0,0 +1,165 @@
+#pragma once
+#include <GL/glew.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 帧内分段计时：CPU 用 steady_clock，GPU 用 GL_TIME_ELAPSED 查询
+ *
+ * 每帧：beginFrame() → 若干对 beginZone()/endZone()（可嵌套）→ endFrame()。
+ * GPU 查询按帧轮流使用 FRAME_LATENCY 组，结果在之后的帧里以非阻塞方式取回，默认从不等待 GPU；
+ * 某组查询再次被使用时仍未完成，则丢弃那一帧的结果（计入 getDroppedFrames()）。
+ * 基准测试等需要每帧结果的场合可用 setBlocking() 改为等待，并用 setFrameCallback() 逐帧取得总时间。
+ *
+ * GL_TIME_ELAPSED 查询不能嵌套，因此只有祖先区段都没有 GPU 查询的区段才计 GPU 时间，
+ * 其余区段只计 CPU 时间（gpuMs 为负）。
+ */
+class Profiler {
+public:
+    static constexpr int FRAME_LATENCY = 3;     // 与 StreamBuffer::REGION_COUNT 一致：GPU 最多落后这么多帧
+    static constexpr int HISTORY_SIZE = 240;    // 帧时间曲线保留的帧数
+
+    /**
+     * @brief 一个区段在某一帧的结果
+     */
+    struct ZoneResult {
+        std::string name;
+        int depth = 0;          // 嵌套深度（0 为顶层）
+        double cpuMs = 0.0;
+        double gpuMs = -1.0;    // 没有 GPU 查询时为负
+    };
+
+    /**
+     * @brief 一帧结果取回时的回调：帧序号（从 0 起，按 endFrame() 计数）、CPU 帧时间、各 GPU 区段之和（毫秒）
+     */
+    using FrameCallback = std::function<void(uint64_t frame, double cpuMs, double gpuMs)>;
+
+    /**
+     * @brief RAII 区段；profiler 为空时什么也不做
+     */
+    class Scope {
+    public:
+        Scope(Profiler* profiler, const char* name, bool gpu = true) : m_profiler(profiler) {
+            if (m_profiler) m_profiler->beginZone(name, gpu);
+        }
+        ~Scope() {
+            if (m_profiler) m_profiler->endZone();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Profiler* m_profiler;
+    };
+
+    Profiler();
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void beginFrame();
+    void endFrame();
+
+    /**
+     * @brief 开始一个区段
+     * @param name 区段名
+     * @param gpu 是否同时测量 GPU 时间（例如交换缓冲这类只关心 CPU 的区段传 false）
+     */
+    void beginZone(const char* name, bool gpu = true);
+    void endZone();
+
+    /**
+     * @brief 关闭后 begin/end 都不做任何事
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief 为 true 时查询组被复用前等待其结果，而不是丢弃那一帧（GPU 落后过多时会让 CPU 等待）
+     */
+    void setBlocking(bool blocking) { m_blocking = blocking; }
+
+    /**
+     * @brief 每帧结果取回时（按帧顺序）调用；被丢弃的帧不调用
+     */
+    void setFrameCallback(FrameCallback callback) { m_frameCallback = std::move(callback); }
+
+    /**
+     * @brief 等待并取回所有已结束帧的结果（例如退出前收集最后几帧）
+     */
+    void flush();
+
+    /**
+     * @brief 最近一个 GPU 结果已全部取回的帧的各区段（按开始顺序）
+     */
+    const std::vector<ZoneResult>& getZones() const { return m_latest; }
+
+    double getCpuFrameMs() const { return m_latestCpuMs; }
+
+    /**
+     * @brief 各 GPU 区段之和（查询互不重叠）
+     */
+    double getGpuFrameMs() const { return m_latestGpuMs; }
+
+    /**
+     * @brief 帧时间曲线（环形，最早的一帧位于 getHistoryOffset()）
+     */
+    const float* getCpuHistory() const { return m_cpuHistory; }
+    const float* getGpuHistory() const { return m_gpuHistory; }
+    int getHistoryOffset() const { return m_historyOffset; }
+
+    /**
+     * @brief 因 GPU 结果未及时完成而丢弃的帧数
+     */
+    uint64_t getDroppedFrames() const { return m_dropped; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct ZoneRecord {
+        std::string name;
+        int depth = 0;
+        Clock::time_point start;
+        double cpuMs = 0.0;
+        int query = -1;         // 本帧查询组中的下标
+    };
+
+    struct FrameSlot {
+        std::vector<ZoneRecord> zones;  // 跨帧复用（避免每帧重新分配名字），前 zoneCount 个有效
+        size_t zoneCount = 0;
+        std::vector<GLuint> queries;    // 跨帧复用，不够时追加
+        size_t queryCount = 0;          // 本帧使用的查询数
+        Clock::time_point start;
+        double cpuMs = 0.0;
+        uint64_t frame = 0;             // 帧序号
+        bool pending = false;           // 已结束、GPU 结果尚未取回
+    };
+
+    /**
+     * @brief 取回一帧的 GPU 结果并发布；wait 为 false 且结果未完成时返回 false
+     */
+    bool resolve(FrameSlot& slot, bool wait = false);
+
+    FrameSlot m_slots[FRAME_LATENCY];
+    uint64_t m_frame = 0;
+    bool m_inFrame = false;
+    bool m_enabled = true;
+    bool m_blocking = false;
+    FrameCallback m_frameCallback;
+    std::vector<size_t> m_stack;        // 未结束的区段
+    bool m_gpuActive = false;           // 是否有进行中的 GPU 查询
+
+    std::vector<ZoneResult> m_latest;
+    double m_latestCpuMs = 0.0;
+    double m_latestGpuMs = 0.0;
+    float m_cpuHistory[HISTORY_SIZE] = {};
+    float m_gpuHistory[HISTORY_SIZE] = {};
+    int m_historyOffset = 0;
+    uint64_t m_dropped = 0;
+};
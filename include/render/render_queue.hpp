@@ -0,0 +1,101 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "shapes.hpp"
+#include "shader.hpp"
+
+/**
+ * @brief 每帧渲染统计，用于比较排序前后的状态切换次数
+ */
+struct RenderStats {
+    uint32_t drawCalls = 0;     // 绘制调用次数
+    uint32_t programBinds = 0;  // glUseProgram 次数
+    uint32_t vaoBinds = 0;      // glBindVertexArray 次数（含解绑）
+    uint32_t modelUploads = 0;  // model / normalMatrix uniform 上传次数
+    uint32_t visible = 0;       // 通过视锥体剔除的形状数
+    uint32_t culled = 0;        // 被视锥体剔除的形状数
+    uint32_t occluded = 0;      // 被遮挡剔除的形状数
+    uint32_t triangles = 0;     // 提交的三角形数
+    uint32_t lodTrianglesSaved = 0;  // LOD 相比最高细节少提交的三角形数
+    float frameTime = 0.0f;     // 帧时间（秒）
+
+    void reset() { *this = RenderStats(); }
+};
+
+/**
+ * @brief 渲染队列中的一个绘制包
+ */
+struct DrawPacket {
+    uint64_t key;       // 排序键
+    Shader* shader;     // 使用的着色器
+    DrawCommand cmd;    // 几何信息
+    glm::mat4 model;    // 本帧的模型矩阵（入队时计算一次）
+    glm::mat3 normal;   // 法线矩阵（随模型矩阵缓存）
+    glm::vec3 color;    // 形状颜色（通用顶点属性 location 2）
+};
+
+/**
+ * @brief 排序渲染队列
+ *
+ * 每帧：clear() → 若干次 push() → submit()。
+ * 绘制包按 64 位排序键升序提交，键的布局（高位到低位）：
+ *  - [63..56] 着色器程序的队列内编号（8 位）
+ *  - [55..40] VAO / 网格的队列内编号（16 位）
+ *  - [39..24] 材质（16 位）
+ *  - [23..0]  视空间深度（24 位，由近及远，用于不透明物体的提前深度剔除）
+ * 程序与 VAO 的 GL 名称不连续且可能超出位宽，入队时按首次出现的顺序映射为连续编号再打包，
+ * 避免不同对象落入同一分组。编号用尽（256 个程序 / 65536 个 VAO）后其余对象共用最后一个编号，
+ * 结果仍然正确，只是分组不再最优。
+ * 提交时只在程序或 VAO 真正改变时才重新绑定。
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief 清空队列（保留已分配的内存）
+     */
+    void clear();
+
+    /**
+     * @brief 将一个形状加入队列
+     * @param shader 绘制使用的着色器
+     * @param shape 形状
+     * @param view 当前视图矩阵，用于计算排序深度
+     * @param material 材质编号（默认 0）
+     */
+    void push(Shader* shader, const ColoredShape& shape, const glm::mat4& view, uint16_t material = 0);
+
+    /**
+     * @brief 排序并提交所有绘制包
+     * @param stats 累加本次提交的统计信息
+     */
+    void submit(RenderStats& stats);
+
+    /**
+     * @brief 队列中的绘制包数量
+     */
+    size_t size() const { return m_packets.size(); }
+
+    /**
+     * @brief 生成排序键
+     * @param programIndex 着色器程序的队列内编号（只取低 8 位）
+     * @param vaoIndex VAO 的队列内编号（只取低 16 位）
+     * @param material 材质编号
+     * @param depth 视空间深度（到摄像机的距离，负值按 0 处理）
+     * @return 64 位排序键
+     */
+    static uint64_t makeSortKey(uint32_t programIndex, uint32_t vaoIndex, uint16_t material, float depth);
+
+private:
+    /**
+     * @brief GL 名称 → 连续编号；新名称取下一个编号，超过 limit 后返回 limit
+     */
+    static uint32_t denseIndex(std::unordered_map<GLuint, uint32_t>& indices, GLuint name, uint32_t limit);
+
+    std::unordered_map<GLuint, uint32_t> m_programIndices;  // 每帧随 clear() 清空
+    std::unordered_map<GLuint, uint32_t> m_vaoIndices;
+    std::vector<DrawPacket> m_packets;
+    std::vector<std::pair<uint64_t, uint32_t>> m_order;  // (排序键, 包索引)，排序时避免移动整个包
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @brief 轴对齐包围盒
+ *
+ * 默认构造为空盒（min > max），可通过 expand() 逐点扩展。
+ */
+struct AABB {
+    glm::vec3 min = glm::vec3(1e30f);
+    glm::vec3 max = glm::vec3(-1e30f);
+
+    AABB() = default;
+    AABB(const glm::vec3& _min, const glm::vec3& _max) : min(_min), max(_max) {}
+
+    bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+
+    /**
+     * @brief 表面积（SAH 代价估计使用）
+     */
+    float getSurfaceArea() const {
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    void expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void expand(const AABB& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    bool contains(const AABB& other) const {
+        return other.min.x >= min.x && other.min.y >= min.y && other.min.z >= min.z &&
+               other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    static AABB merge(const AABB& a, const AABB& b) {
+        return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+};
+
+/**
+ * @brief 包围球
+ */
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+/**
+ * @brief 把局部包围盒变换到另一个空间（结果为包住变换后盒子的 AABB）
+ * @param local 局部包围盒
+ * @param transform 仿射变换矩阵
+ * @return 变换后的包围盒
+ */
+AABB transformAABB(const AABB& local, const glm::mat4& transform);
+
+/**
+ * @brief 包住包围盒的球（以盒中心为球心）
+ */
+BoundingSphere sphereFromAABB(const AABB& box);
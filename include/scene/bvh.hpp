@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounds.hpp"
+#include "frustum.hpp"
+
+/**
+ * @brief 射线（direction 无需归一化，距离以 direction 的长度为单位）
+ */
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+/**
+ * @brief 动态包围体层次（BVH）
+ *
+ * - insert()：按 SAH 代价自顶向下选择兄弟节点插入，O(log n)
+ * - update()：只更新叶子包围盒并向上重新拟合祖先节点（refit），不改变拓扑
+ * - rebuild()：按分箱 SAH 自顶向下完全重建；当树代价相对上次重建增长超过阈值时由
+ *   rebuildIfDegraded() 触发
+ * - 同一棵树同时用于视锥体剔除（queryFrustum）与射线查询（raycast）
+ *
+ * 叶子以代理 ID 标识，ID 在 remove() 之前保持不变。
+ */
+class DynamicBVH {
+public:
+    static constexpr int NULL_NODE = -1;
+
+    DynamicBVH() = default;
+
+    /**
+     * @brief 插入叶子
+     * @param bounds 包围盒
+     * @param userData 用户数据（查询结果中返回）
+     * @return 代理 ID
+     */
+    int insert(const AABB& bounds, void* userData);
+
+    /**
+     * @brief 删除叶子
+     * @param proxy insert() 返回的代理 ID
+     */
+    void remove(int proxy);
+
+    /**
+     * @brief 更新叶子包围盒并重新拟合祖先
+     * @param proxy 代理 ID
+     * @param bounds 新包围盒
+     */
+    void update(int proxy, const AABB& bounds);
+
+    /**
+     * @brief 以分箱 SAH 完全重建
+     */
+    void rebuild();
+
+    /**
+     * @brief 当前代价超过上次重建时的 threshold 倍则重建
+     * @param threshold 允许的代价增长倍数
+     * @return 是否发生了重建
+     */
+    bool rebuildIfDegraded(float threshold = 1.5f);
+
+    /**
+     * @brief 收集与视锥体相交的叶子
+     * @param frustum 视锥体
+     * @param out 输出：叶子的用户数据（追加，不清空）
+     *
+     * 完全位于视锥体内的子树不再逐个测试。
+     */
+    void queryFrustum(const Frustum& frustum, std::vector<void*>& out) const;
+
+    /**
+     * @brief 求射线命中的最近叶子（以包围盒为准）
+     * @param ray 射线
+     * @param maxDistance 最大距离
+     * @param hitDistance 输出：命中距离（可为空）
+     * @return 命中叶子的用户数据；未命中返回 nullptr
+     */
+    void* raycast(const Ray& ray, float maxDistance, float* hitDistance = nullptr) const;
+
+    /**
+     * @brief 树的 SAH 代价：所有内部节点表面积之和除以根表面积
+     */
+    float getCost() const;
+
+    /**
+     * @brief 树高（只有一个叶子时为 0）
+     */
+    int getHeight() const;
+
+    size_t getProxyCount() const { return m_leafCount; }
+    const AABB& getBounds(int proxy) const { return m_nodes[proxy].bounds; }
+    void* getUserData(int proxy) const { return m_nodes[proxy].userData; }
+
+private:
+    struct Node {
+        AABB bounds;
+        void* userData = nullptr;
+        int parent = NULL_NODE;
+        int left = NULL_NODE;     // 叶子为 NULL_NODE；空闲节点复用为下一个空闲节点
+        int right = NULL_NODE;
+        int height = 0;           // 叶子为 0，空闲节点为 -1
+
+        bool isLeaf() const { return left == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    void refitAncestors(int node);
+    int buildRange(int* leaves, int count, int parent);
+
+    std::vector<Node> m_nodes;
+    int m_root = NULL_NODE;
+    int m_freeList = NULL_NODE;
+    size_t m_leafCount = 0;
+    float m_builtCost = 0.0f;   // 上次重建后的代价
+
+    // 查询与重建时复用的临时数据
+    mutable std::vector<int> m_stack;
+    std::vector<int> m_buildLeaves;
+    std::vector<glm::vec3> m_buildCentroids;    // 按节点索引存放叶子中心
+};
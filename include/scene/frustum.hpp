@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "bounds.hpp"
+
+/**
+ * @brief 视锥体（六个平面，法线朝内）
+ *
+ * 平面由视图投影矩阵提取（Gribb-Hartmann），并已归一化，
+ * 因此 dot(plane.xyz, p) + plane.w 即为点到平面的有符号距离。
+ */
+class Frustum {
+public:
+    enum Plane { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+    Frustum() = default;
+
+    /**
+     * @brief 从视图投影矩阵提取平面
+     * @param viewProjection projection * view
+     */
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    const glm::vec4& getPlane(int index) const { return m_planes[index]; }
+
+    /**
+     * @brief 包围球是否与视锥体相交（保守测试）
+     */
+    bool testSphere(const glm::vec3& center, float radius) const;
+
+    /**
+     * @brief 包围盒是否与视锥体相交（保守测试）
+     */
+    bool testAABB(const AABB& box) const;
+
+    /**
+     * @brief 批量测试包围球（SoA 输入）
+     * @param x 球心 X 数组
+     * @param y 球心 Y 数组
+     * @param z 球心 Z 数组
+     * @param radius 半径数组
+     * @param count 球的数量
+     * @param visible 输出：可见为 1，否则为 0
+     *
+     * 编译时启用 AVX 时每次处理 8 个，否则使用 SSE 每次处理 4 个；其余部分逐个处理。
+     */
+    void testSpheres(const float* x, const float* y, const float* z, const float* radius,
+                     size_t count, uint8_t* visible) const;
+
+private:
+    glm::vec4 m_planes[PLANE_COUNT];
+};
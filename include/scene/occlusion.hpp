@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounds.hpp"
+
+class WorkerPool;
+
+/**
+ * @brief CPU 软件遮挡剔除（层次 Z）
+ *
+ * 每帧：
+ *  1. beginFrame()：设置视图投影矩阵并清空遮挡体
+ *  2. addOccluder()：加入遮挡体三角形（变换到屏幕空间并保存）
+ *  3. rasterize()：按瓦片分箱，在常驻线程池上并行光栅化到低分辨率深度缓冲（SSE 每次 4 像素）
+ *  4. buildHiZ()：逐级取 2x2 最大深度生成 Hi-Z 金字塔
+ *  5. isVisible()：用包围盒的屏幕矩形与最近深度在合适的 mip 层上保守测试
+ *
+ * 深度为 [0, 1]（NDC z * 0.5 + 0.5），清除值为 1。像素中心落在边上时按左上填充规则判定，
+ * 共享一条边的相邻三角形不会重复或遗漏像素。不依赖 OpenGL。
+ */
+class OcclusionCuller {
+public:
+    static constexpr int TILE_SIZE = 32;   // 瓦片边长（像素），宽高会向上取整到其倍数
+
+    /**
+     * @brief 构造
+     * @param width 深度缓冲宽度（像素）
+     * @param height 深度缓冲高度（像素）
+     * @param pool 光栅化使用的线程池；为空时使用 WorkerPool::shared()（与分簇光照共用）
+     */
+    OcclusionCuller(int width = 256, int height = 128, WorkerPool* pool = nullptr);
+
+    /**
+     * @brief 开始新的一帧
+     * @param viewProjection projection * view
+     */
+    void beginFrame(const glm::mat4& viewProjection);
+
+    /**
+     * @brief 加入遮挡体
+     * @param vertices 局部空间顶点
+     * @param indices 三角形索引（每 3 个一个三角形）
+     * @param model 模型矩阵
+     *
+     * 与近平面相交的三角形会被丢弃（只会少遮挡，结果仍然保守）。
+     */
+    void addOccluder(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices,
+                     const glm::mat4& model);
+
+    /**
+     * @brief 光栅化本帧加入的所有遮挡体
+     */
+    void rasterize();
+
+    /**
+     * @brief 生成 Hi-Z 金字塔（需在 rasterize() 之后调用）
+     */
+    void buildHiZ();
+
+    /**
+     * @brief 世界包围盒是否可能可见
+     * @param worldBounds 世界空间包围盒
+     * @return 被遮挡时返回 false；不确定时返回 true
+     */
+    bool isVisible(const AABB& worldBounds) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    size_t getTriangleCount() const { return m_triangles.size(); }
+    int getMipCount() const { return (int)m_mips.size(); }
+
+    /**
+     * @brief 获取某一层的深度数据（第 0 层为光栅化结果）
+     */
+    const std::vector<float>& getDepth(int level = 0) const { return m_mips[level].depth; }
+
+    /**
+     * @brief 限制并行光栅化的线程数；0 表示使用线程池的全部线程
+     */
+    void setThreadCount(unsigned threadCount) { m_threadCount = threadCount; }
+
+private:
+    // 屏幕空间三角形（像素坐标，深度 [0, 1]）
+    struct ScreenTriangle {
+        float x[3], y[3], z[3];
+        int minTileX, minTileY, maxTileX, maxTileY;
+    };
+
+    struct MipLevel {
+        int width, height;
+        std::vector<float> depth;
+    };
+
+    void rasterizeTile(int tileIndex);
+    void rasterizeTriangle(const ScreenTriangle& tri, int x0, int y0, int x1, int y1);
+
+    int m_width, m_height;
+    int m_tilesX, m_tilesY;
+    WorkerPool* m_pool;
+    unsigned m_threadCount = 0;
+    glm::mat4 m_viewProjection = glm::mat4(1.0f);
+
+    std::vector<ScreenTriangle> m_triangles;
+    std::vector<std::vector<uint32_t>> m_tileBins;  // 每个瓦片覆盖的三角形索引
+    std::vector<MipLevel> m_mips;                    // 第 0 层即深度缓冲
+    std::vector<glm::vec4> m_clipVertices;          // addOccluder 复用的临时数据
+};
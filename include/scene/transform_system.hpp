@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief 批量矩阵计算使用的指令集
+ */
+enum class SimdLevel {
+    SCALAR,     // 逐个计算（std::sin/std::cos）
+    SSE,        // 每次 4 个变换
+    AVX2        // 每次 8 个变换（运行时检测到 AVX2 + FMA 才可用）
+};
+
+/**
+ * @brief SoA 变换存储与批量模型矩阵计算
+ *
+ * 位置、旋转（欧拉角，度）、缩放按分量存放在连续数组中，update() 按 8 个一组
+ * 跳过未修改的块，对修改过的块用 SIMD 内核一次计算多个矩阵：
+ *     model = T(position) * Rx * Ry * Rz * S(scale)
+ * 与 Shape::getModelMatrix() 的组合顺序一致。结果以 glm::mat4 数组连续存放，
+ * 可直接上传到实例缓冲。
+ *
+ * 句柄在 destroy() 前保持有效；内部数组删除时与末尾交换，保持紧凑。
+ * 不依赖 OpenGL。
+ */
+class TransformSystem {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    /**
+     * @brief 构造
+     * @param capacity 预分配的变换数量
+     */
+    explicit TransformSystem(size_t capacity = 0);
+
+    /**
+     * @brief 创建变换
+     * @return 句柄
+     */
+    Handle create(const glm::vec3& position = glm::vec3(0.0f),
+                  const glm::vec3& rotation = glm::vec3(0.0f),
+                  const glm::vec3& scale = glm::vec3(1.0f));
+
+    /**
+     * @brief 删除变换（末尾元素会被移到空出的位置）
+     */
+    void destroy(Handle handle);
+
+    void setPosition(Handle handle, const glm::vec3& position);
+    void move(Handle handle, const glm::vec3& offset);
+    void setRotation(Handle handle, const glm::vec3& rotation);
+    void setScale(Handle handle, const glm::vec3& scale);
+
+    glm::vec3 getPosition(Handle handle) const;
+    glm::vec3 getRotation(Handle handle) const;
+    glm::vec3 getScale(Handle handle) const;
+
+    /**
+     * @brief 重新计算修改过的矩阵
+     */
+    void update();
+
+    /**
+     * @brief 重新计算全部矩阵（批量修改了大部分变换时比逐个标脏更快）
+     */
+    void updateAll();
+
+    /**
+     * @brief 获取模型矩阵（需先调用 update()）
+     */
+    const glm::mat4& getMatrix(Handle handle) const { return m_matrices[m_handleToIndex[handle]]; }
+
+    /**
+     * @brief 紧凑存放的全部矩阵，下标与 getIndex() 对应
+     */
+    const glm::mat4* getMatrices() const { return m_matrices.data(); }
+
+    /**
+     * @brief 句柄在紧凑数组中的当前下标（destroy() 后可能改变）
+     */
+    size_t getIndex(Handle handle) const { return m_handleToIndex[handle]; }
+
+    size_t size() const { return m_px.size(); }
+
+    /**
+     * @brief 指定批量计算使用的指令集（超出 CPU 支持时降级到可用的最高级别）
+     */
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return m_simdLevel; }
+
+    /**
+     * @brief 检测当前 CPU 与编译配置支持的最高指令集
+     */
+    static SimdLevel detectSimdLevel();
+
+    static const char* getSimdLevelName(SimdLevel level);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 8;  // 脏标记按块检查，与 AVX2 宽度一致
+    static constexpr size_t STREAMING_THRESHOLD = 1 << 16;  // 超过 4MB 的全量结果改用非临时写
+
+    void markDirty(size_t index) { m_dirty[index] = 1; m_anyDirty = true; }
+
+    /**
+     * @brief 计算 [begin, end) 区间内的矩阵
+     * @param streaming 是否使用非临时写
+     */
+    void compose(size_t begin, size_t end, bool streaming);
+
+    // SoA 分量
+    std::vector<float> m_px, m_py, m_pz;
+    std::vector<float> m_rx, m_ry, m_rz;
+    std::vector<float> m_sx, m_sy, m_sz;
+
+    std::vector<glm::mat4> m_matrices;
+    std::vector<uint8_t> m_dirty;
+    bool m_anyDirty = false;
+
+    // 句柄 <-> 紧凑下标
+    std::vector<uint32_t> m_handleToIndex;
+    std::vector<Handle> m_indexToHandle;
+    std::vector<Handle> m_freeHandles;
+
+    SimdLevel m_simdLevel;
+};
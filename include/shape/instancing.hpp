@@ -0,0 +1,243 @@
+#pragma once
+#include <GL/glew.h>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "shapes.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+#include "stream_buffer.hpp"
+#include <scene/transform_system.hpp>
+
+/**
+ * @brief 单个实例的 GPU 数据（逐实例属性）
+ *
+ * 顶点着色器中：location 2 为实例颜色，location 3~6 为实例模型矩阵，location 7~9 为实例法线矩阵。
+ */
+struct InstanceData {
+    glm::mat4 model;    // 模型矩阵
+    glm::vec4 color;    // 颜色（rgb，a 保留）
+    glm::mat3 normal;   // 法线矩阵（写入模型矩阵时在 CPU 端计算）
+};
+
+/**
+ * @brief 实例化批次：共享一份几何体，N 个实例只需一次绘制调用
+ *
+ * 几何体来自 MeshCache 的单位网格（只包含位置与法线），尺寸折算进每个实例的模型矩阵；
+ * 颜色与模型矩阵作为逐实例属性存放在实例缓冲中。
+ * 绘制时会把着色器的 useInstancing uniform 置为 true，结束后恢复为 false。
+ *
+ * 按位置/旋转/缩放加入的实例由批次内的 TransformSystem 保存（SoA），修改后在下一次
+ * updateTransforms()（绘制与选择 LOD 前自动调用）中用 SIMD 内核批量重算模型矩阵。
+ *
+ * 派生类可以提供多个细节层级的网格并为每个实例选择层级（见 updateLOD()）：
+ * 实例按层级分组连续存放，每个非空层级一次绘制调用，实例属性指针指向该组的起始位置。
+ */
+class InstanceBatch {
+public:
+    virtual ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch&) = delete;
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    /**
+     * @brief 增加一个实例
+     * @param model 实例的模型矩阵
+     * @param color 实例颜色 (r,g,b)
+     * @return 实例下标
+     */
+    size_t addInstance(const glm::mat4& model, const glm::vec3& color = glm::vec3(1.0f));
+
+    /**
+     * @brief 在指定位置增加一个实例（无旋转、无缩放）
+     * @param position 世界坐标
+     * @param color 实例颜色 (r,g,b)
+     * @return 实例下标
+     */
+    size_t addInstance(const glm::vec3& position, const glm::vec3& color = glm::vec3(1.0f));
+
+    /**
+     * @brief 按位置、旋转与缩放增加一个实例（组合顺序与 Shape 相同：T * Rx * Ry * Rz * S）
+     * @param position 世界坐标
+     * @param rotation 欧拉角 (pitch, yaw, roll)，单位为度
+     * @param scale 缩放
+     * @param color 实例颜色 (r,g,b)
+     * @return 实例下标
+     */
+    size_t addInstance(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale,
+                       const glm::vec3& color = glm::vec3(1.0f));
+
+    /**
+     * @brief 修改实例的模型矩阵（按位置/旋转/缩放加入的实例之后改由该矩阵决定）
+     */
+    void setInstanceModel(size_t index, const glm::mat4& model);
+
+    /**
+     * @brief 修改按位置/旋转/缩放加入的实例（对以矩阵加入的实例无效），矩阵延迟到 updateTransforms() 批量计算
+     */
+    void setInstancePosition(size_t index, const glm::vec3& position);
+    void setInstanceRotation(size_t index, const glm::vec3& rotation);
+    void setInstanceScale(size_t index, const glm::vec3& scale);
+
+    /**
+     * @brief 批量重新计算修改过的实例变换
+     */
+    void updateTransforms();
+
+    /**
+     * @brief 修改实例颜色
+     */
+    void setInstanceColor(size_t index, const glm::vec3& color);
+
+    /**
+     * @brief 删除所有实例
+     */
+    void clearInstances();
+
+    /**
+     * @brief 当前实例数量
+     */
+    size_t getInstanceCount() const { return m_instances.size(); }
+
+    /**
+     * @brief 绘制全部实例（一次绘制调用）
+     * @param shader 当前激活的着色器，需定义 useInstancing uniform
+     */
+    void draw(Shader& shader);
+
+    /**
+     * @brief 设置每帧实例数据使用的流式缓冲
+     *
+     * 设置后每次 draw() 都把全部实例写入流式缓冲的本帧区域，不再通过 glBufferSubData 更新实例缓冲；
+     * 适合每帧都会修改的实例。传入 nullptr 恢复使用静态实例缓冲。
+     */
+    void setStreamBuffer(StreamBuffer* stream) { m_stream = stream; }
+
+    /**
+     * @brief 获取最高细节的实例化绘制命令（instanceCount 为当前实例数）
+     */
+    DrawCommand getDrawCommand() const;
+
+    /**
+     * @brief 为每个实例选择细节层级（默认只有一级）
+     * @param cameraPosition 摄像机世界坐标
+     * @param pixelsPerUnit 距离为 1 处一个世界单位对应的像素数；+inf 表示强制最高细节
+     * @return 相比最高细节本帧少绘制的三角形数
+     */
+    virtual uint32_t updateLOD(const glm::vec3& /*cameraPosition*/, float /*pixelsPerUnit*/) { return 0; }
+
+    /**
+     * @brief 按当前各层级的实例数统计的绘制调用数与三角形数
+     */
+    uint32_t getDrawCallCount() const;
+    uint32_t getTriangleCount() const;
+
+protected:
+    InstanceBatch() = default;
+
+    /**
+     * @brief 引用共享网格并设置 VAO（由派生类构造时调用）
+     * @param mesh 单位网格
+     * @param meshScale 网格固有尺寸，写入实例时乘到模型矩阵上
+     */
+    void setupGeometry(std::shared_ptr<Mesh> mesh, const glm::vec3& meshScale);
+
+    /**
+     * @brief 引用各细节层级的共享网格，每级一个 VAO（由派生类构造时调用）
+     * @param lodMeshes 各层级的单位网格，第 0 级为最高细节
+     * @param meshScale 网格固有尺寸，写入实例时乘到模型矩阵上
+     */
+    void setupGeometry(const std::vector<std::shared_ptr<Mesh>>& lodMeshes, const glm::vec3& meshScale);
+
+    /**
+     * @brief 实例的模型矩阵（已乘网格固有尺寸；按位置/旋转/缩放修改后需先 updateTransforms()）
+     */
+    const glm::mat4& getInstanceModel(size_t index) const { return m_instances[index].model; }
+
+    int getInstanceLevel(size_t index) const { return m_instanceLevels[index]; }
+    void setInstanceLevel(size_t index, int level);
+
+    int getLevelCount() const { return (int)m_levels.size(); }
+    const std::shared_ptr<Mesh>& getLevelMesh(int level) const { return m_levels[level].mesh; }
+
+private:
+    /**
+     * @brief 一个细节层级的几何体与其 VAO 当前的实例属性来源
+     */
+    struct Level {
+        std::shared_ptr<Mesh> mesh;
+        GLuint vao = 0;
+        GLuint attributeBuffer = 0;     // 实例属性指针当前指向的缓冲与偏移，变化时才重新设置
+        GLintptr attributeOffset = -1;
+    };
+
+    /**
+     * @brief 按层级分组后的实例数据（只有一级时直接返回 m_instances）
+     */
+    const std::vector<InstanceData>& getOrderedInstances();
+
+    /**
+     * @brief 若实例数据有改动，则上传到实例缓冲
+     */
+    void uploadInstances(const std::vector<InstanceData>& instances);
+
+    /**
+     * @brief 实例的变换已修改，等待 updateTransforms()
+     */
+    void markTransformDirty(size_t index);
+
+    /**
+     * @brief 设置 location 2~9 的实例属性指针（需已绑定 VAO，并把实例数据所在缓冲绑定到 GL_ARRAY_BUFFER）
+     * @param baseOffset 实例数据在缓冲中的起始偏移
+     */
+    void setInstanceAttributes(GLintptr baseOffset);
+
+    GLuint instanceVBO = 0;
+    std::vector<Level> m_levels;    // 细节层级，第 0 级为最高细节
+    glm::mat4 m_meshScale = glm::mat4(1.0f);  // 网格固有尺寸对应的缩放矩阵
+
+    std::vector<InstanceData> m_instances;
+    std::vector<uint8_t> m_instanceLevels;  // 每个实例的细节层级
+
+    // 按位置/旋转/缩放加入的实例的变换；以矩阵加入的实例句柄为 INVALID_HANDLE
+    TransformSystem m_transforms;
+    std::vector<TransformSystem::Handle> m_instanceTransforms;
+    std::vector<uint8_t> m_transformQueued;         // 已在 m_dirtyTransforms 中
+    std::vector<size_t> m_dirtyTransforms;          // 变换修改过的实例下标
+    std::vector<InstanceData> m_ordered;    // 按层级分组后的实例数据（多于一级时使用）
+    std::vector<size_t> m_levelCounts;      // 每个层级的实例数
+    bool m_orderDirty = false;              // 实例数据或层级改变，需要重新分组
+    size_t m_gpuCapacity = 0;       // 实例缓冲当前可容纳的实例数
+    bool m_dirty = false;
+
+    StreamBuffer* m_stream = nullptr;   // 每帧实例数据的流式缓冲（不持有）
+};
+
+// 实例化立方体
+class CubeBatch : public InstanceBatch {
+public:
+    /**
+     * @brief 构造立方体批次
+     * @param size 所有实例共享的边长
+     */
+    explicit CubeBatch(float size);
+};
+
+// 实例化球体
+class SphereBatch : public InstanceBatch {
+public:
+    /**
+     * @brief 构造球体批次
+     * @param radius 所有实例共享的半径
+     * @param sectors 经向分段数
+     * @param stacks 纬向分段数
+     *
+     * 与 Sphere 相同，共享 Sphere::LOD_COUNT 级细节网格。
+     */
+    SphereBatch(float radius, int sectors = 36, int stacks = 18);
+
+    /**
+     * @brief 逐实例按屏幕半径选择细节层级（阈值与滞回同 Sphere）
+     */
+    virtual uint32_t updateLOD(const glm::vec3& cameraPosition, float pixelsPerUnit) override;
+};
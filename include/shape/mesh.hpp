@@ -0,0 +1,214 @@
+#pragma once
+#include <GL/glew.h>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "shapes.hpp"
+#include "vertex_format.hpp"
+#include "mesh_optimizer.hpp"
+
+// 可缓存的程序化图元类型
+enum class PrimitiveType {
+    CUBE = 0,
+    SPHERE
+};
+
+/**
+ * @brief 网格缓存键：图元类型 + 细分参数 + 顶点格式
+ */
+struct MeshKey {
+    PrimitiveType type;
+    int sectors;    // 球体经向分段数（立方体为 0）
+    int stacks;     // 球体纬向分段数（立方体为 0）
+    VertexFormat format = VertexFormat::getDefault();
+
+    bool operator==(const MeshKey& other) const {
+        return type == other.type && sectors == other.sectors && stacks == other.stacks &&
+               format == other.format;
+    }
+};
+
+struct MeshKeyHash {
+    size_t operator()(const MeshKey& key) const {
+        size_t h = static_cast<size_t>(key.type);
+        h = h * 31 + static_cast<size_t>(key.sectors);
+        h = h * 31 + static_cast<size_t>(key.stacks);
+        h = h * 31 + static_cast<size_t>(key.format.position);
+        h = h * 31 + static_cast<size_t>(key.format.normal);
+        return h;
+    }
+};
+
+/**
+ * @brief 网格上传到 GPU 后 CPU 端顶点/索引的去留
+ */
+enum class CpuResidency {
+    DISCARD = 0,    // 上传后释放（默认）
+    RETAIN          // 保留一份副本，供拾取、物理等 CPU 端查询
+};
+
+/**
+ * @brief 上传到 GPU 的单位尺寸网格（位置 + 法线），可被多个形状共享
+ *
+ * 网格本身不含颜色：颜色通过通用顶点属性（location 2）在绘制前设置，
+ * 尺寸（半径/边长）由形状折算进模型矩阵。顶点按 VertexFormat 压缩存放。
+ */
+class Mesh {
+public:
+    /**
+     * @brief 上传网格数据
+     * @param vertices 交错的顶点数据：位置(3) + 法线(3)
+     * @param indices 三角形索引；为空表示非索引绘制。顶点数不超过 65536 时以 16 位索引上传
+     * @param format 顶点格式
+     * @param usage 顶点缓冲的用途提示；之后会调用 updateVertices() 的网格应使用 GL_DYNAMIC_DRAW
+     * @param residency 上传后是否保留 CPU 端副本
+     */
+    Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+         const VertexFormat& format = VertexFormat::getDefault(), GLenum usage = GL_STATIC_DRAW,
+         CpuResidency residency = getDefaultResidency());
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    /**
+     * @brief 把顶点缓冲/索引缓冲及 location 0、1 的属性指针设置到当前绑定的 VAO 上
+     *
+     * 实例化批次等需要自建 VAO 的场合可复用同一份缓冲。
+     */
+    void setupVertexAttributes() const;
+
+    /**
+     * @brief 获取绘制该网格的命令
+     */
+    DrawCommand getDrawCommand() const;
+
+    /**
+     * @brief 用 glBufferSubData 更新一段连续顶点，其余顶点不重新上传
+     * @param first 起始顶点下标
+     * @param vertices 交错的顶点数据：位置(3) + 法线(3)；位置需在顶点格式可表示的范围内
+     *
+     * 保留了 CPU 副本时副本同步更新。
+     */
+    void updateVertices(size_t first, const std::vector<float>& vertices);
+
+    /**
+     * @brief 保留的 CPU 端顶点（位置(3) + 法线(3)）与索引；DISCARD 时为空
+     */
+    const std::vector<float>& getCpuVertices() const { return m_cpuVertices; }
+    const std::vector<unsigned int>& getCpuIndices() const { return m_cpuIndices; }
+    bool isCpuResident() const { return m_residency == CpuResidency::RETAIN; }
+
+    /**
+     * @brief CPU 端副本占用的字节数（DISCARD 时为 0）
+     */
+    size_t getCpuBytes() const {
+        return m_cpuVertices.capacity() * sizeof(float) + m_cpuIndices.capacity() * sizeof(unsigned int);
+    }
+
+    /**
+     * @brief 顶点缓冲与索引缓冲占用的显存字节数
+     */
+    size_t getGpuBytes() const {
+        return getVertexBytes() + (size_t)m_indexCount * (m_indexType == GL_UNSIGNED_SHORT ? 2 : 4);
+    }
+
+    /**
+     * @brief 之后创建的网格默认的 CPU 端驻留策略
+     */
+    static CpuResidency getDefaultResidency();
+    static void setDefaultResidency(CpuResidency residency);
+
+    GLsizei getVertexCount() const { return m_vertexCount; }
+    GLsizei getIndexCount() const { return m_indexCount; }
+    const VertexFormat& getVertexFormat() const { return m_format; }
+
+    /**
+     * @brief 顶点缓冲占用的字节数
+     */
+    size_t getVertexBytes() const { return (size_t)m_vertexCount * m_format.getStride(); }
+
+    /**
+     * @brief 索引类型（GL_UNSIGNED_SHORT / GL_UNSIGNED_INT；非索引网格为 0）
+     */
+    GLenum getIndexType() const { return m_indexType; }
+
+    /**
+     * @brief 生成时的优化统计（由 MeshCache 记录）
+     */
+    const MeshOptimizeStats& getOptimizeStats() const { return m_optimizeStats; }
+    void setOptimizeStats(const MeshOptimizeStats& stats) { m_optimizeStats = stats; }
+
+private:
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    VertexFormat m_format;
+    GLsizei m_vertexCount = 0;
+    GLsizei m_indexCount = 0;
+    GLenum m_indexType = 0;
+    MeshOptimizeStats m_optimizeStats;
+
+    CpuResidency m_residency;
+    std::vector<float> m_cpuVertices;
+    std::vector<unsigned int> m_cpuIndices;
+};
+
+/**
+ * @brief 程序化图元的网格缓存
+ *
+ * 同一 (图元类型, 细分) 只生成并上传一次；生成后先经 MeshOptimizer 去重并重排三角形。
+ * 缓存只持有弱引用，最后一个引用该网格的形状析构时网格随之释放。
+ */
+class MeshCache {
+public:
+    /**
+     * @brief 获取（必要时生成）指定键的网格（按键中的顶点格式编码）
+     */
+    static std::shared_ptr<Mesh> get(const MeshKey& key);
+
+    /**
+     * @brief 生成一份不共享、不进入缓存的网格（用于需要修改顶点的形状，即写时复制）
+     *
+     * 与 get() 生成的网格顶点顺序相同；位置格式放宽到可表示 [-1, 1] 以外的坐标，顶点缓冲为 GL_DYNAMIC_DRAW。
+     * 始终保留 CPU 副本，调用方据此读取、修改顶点。
+     * @param key 网格键
+     */
+    static std::shared_ptr<Mesh> createUnique(const MeshKey& key);
+
+    /**
+     * @brief 获取边长为 1 的立方体网格
+     */
+    static std::shared_ptr<Mesh> getCube();
+
+    /**
+     * @brief 获取半径为 1 的球体网格
+     * @param sectors 经向分段数
+     * @param stacks 纬向分段数
+     */
+    static std::shared_ptr<Mesh> getSphere(int sectors, int stacks);
+
+    /**
+     * @brief 当前仍被引用的网格数量
+     */
+    static size_t liveCount();
+
+    /**
+     * @brief 仍被引用的缓存网格占用的显存与 CPU 字节数（每个网格只计一次）
+     */
+    static size_t getGpuBytes();
+    static size_t getCpuBytes();
+
+    /**
+     * @brief 输出仍被引用的网格的顶点数、索引类型与优化前后的 ACMR
+     */
+    static void printStats(std::ostream& out);
+
+private:
+    /**
+     * @brief 生成单位尺寸网格并优化
+     */
+    static MeshOptimizeStats generate(const MeshKey& key, std::vector<float>& vertices,
+                                      std::vector<unsigned int>& indices);
+
+    static inline std::unordered_map<MeshKey, std::weak_ptr<Mesh>, MeshKeyHash> s_meshes;
+};
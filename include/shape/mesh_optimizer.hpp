@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 一次网格优化前后的统计
+ */
+struct MeshOptimizeStats {
+    size_t vertexCountBefore = 0;
+    size_t vertexCountAfter = 0;
+    size_t triangleCount = 0;
+    float acmrBefore = 0.0f;    // 平均缓存未命中率：每个三角形的顶点着色次数（理想值约 0.5~0.7，最差 3）
+    float acmrAfter = 0.0f;
+};
+
+/**
+ * @brief 三角形网格优化（不依赖 OpenGL）
+ *
+ * optimize() 依次执行：
+ *  1. 顶点去重（数据完全相同的顶点合并）
+ *  2. 顶点缓存优化（Forsyth 线性速度算法）
+ *  3. 过绘制优化：按缓存未命中处切分三角形簇，朝外、离中心远的簇先画
+ *  4. 顶点按首次使用的顺序重排，提高顶点读取的局部性
+ *
+ * 顶点为交错的 float 数组，前三个分量为位置。
+ */
+class MeshOptimizer {
+public:
+    static constexpr int CACHE_SIZE = 16;   // 统计 ACMR 使用的 FIFO 缓存大小
+
+    /**
+     * @brief 完整优化
+     * @param vertices 交错顶点数据（原地修改）
+     * @param indices 三角形索引；为空表示顶点按顺序组成三角形（原地修改）
+     * @param stride 每个顶点的 float 数
+     * @return 优化前后的统计
+     */
+    static MeshOptimizeStats optimize(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride);
+
+    /**
+     * @brief 合并完全相同的顶点并重写索引
+     * @return 去重后的顶点数
+     */
+    static size_t deduplicateVertices(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride);
+
+    /**
+     * @brief 按 Forsyth 算法重排三角形，提高变换后顶点缓存命中率
+     * @param vertexCount 顶点数
+     */
+    static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+    /**
+     * @brief 在不明显损失缓存命中率的前提下重排三角形簇以减少过绘制
+     * @param threshold 允许的 ACMR 变差比例（1.05 表示 5%）
+     */
+    static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float>& vertices, int stride,
+                                 float threshold = 1.05f);
+
+    /**
+     * @brief 按索引中首次出现的顺序重排顶点
+     */
+    static void optimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride);
+
+    /**
+     * @brief 模拟 FIFO 顶点缓存，计算平均缓存未命中率
+     */
+    static float computeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize = CACHE_SIZE);
+};
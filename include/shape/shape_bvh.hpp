@@ -0,0 +1,63 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "shapes.hpp"
+#include "bvh.hpp"
+
+/**
+ * @brief 以 DynamicBVH 组织的形状集合
+ *
+ * 加入的形状以本对象为观察者：变换改变时叶子包围盒被重新拟合，
+ * 形状析构时自动移除。maintain() 在树质量下降时按 SAH 重建。
+ */
+class ShapeBVH : public ShapeObserver {
+public:
+    ShapeBVH() = default;
+    ~ShapeBVH() override;
+
+    ShapeBVH(const ShapeBVH&) = delete;
+    ShapeBVH& operator=(const ShapeBVH&) = delete;
+
+    /**
+     * @brief 加入形状（重复加入会被忽略）
+     */
+    void add(ColoredShape* shape);
+
+    /**
+     * @brief 移除形状
+     */
+    void remove(ColoredShape* shape);
+
+    void onBoundsChanged(Shape& shape) override;
+    void onShapeDestroyed(Shape& shape) override;
+
+    /**
+     * @brief 树代价相对上次重建增长超过 threshold 倍时重建
+     * @return 是否发生了重建
+     */
+    bool maintain(float threshold = 1.5f);
+
+    /**
+     * @brief 收集与视锥体相交的形状
+     * @param frustum 视锥体
+     * @param out 输出：可见形状（追加，不清空）
+     */
+    void cull(const Frustum& frustum, std::vector<ColoredShape*>& out) const;
+
+    /**
+     * @brief 射线拾取（以世界包围盒为准）
+     * @param ray 射线
+     * @param maxDistance 最大距离
+     * @param hitDistance 输出：命中距离（可为空）
+     * @return 最近的形状；未命中返回 nullptr
+     */
+    ColoredShape* raycast(const Ray& ray, float maxDistance, float* hitDistance = nullptr) const;
+
+    size_t size() const { return m_proxies.size(); }
+    const DynamicBVH& getTree() const { return m_tree; }
+
+private:
+    DynamicBVH m_tree;
+    std::unordered_map<const Shape*, int> m_proxies;    // 形状 → 叶子代理 ID
+    mutable std::vector<void*> m_queryResult;
+};
@@ -1,9 +1,78 @@
 #pragma once
 #include <GL/glew.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "shader.hpp"
+#include "bounds.hpp"
+#include "vertex_format.hpp"
+
+/**
+ * @brief 一次绘制调用所需的几何信息（不含变换）
+ *
+ * 由形状提供，渲染队列据此排序并只在 VAO 发生变化时重新绑定。
+ */
+struct DrawCommand {
+    GLuint vao;         // 顶点数组对象
+    GLenum mode;        // 图元类型（GL_TRIANGLES、GL_LINES 等）
+    GLsizei count;      // 顶点数（非索引）或索引数（索引）
+    GLenum indexType;   // 索引类型；为 0 表示非索引绘制（glDrawArrays）
+    GLsizei instanceCount = 0;  // 实例数；为 0 表示非实例化绘制
+
+    /**
+     * @brief 发出绘制调用。调用方需保证 vao 已被绑定。
+     */
+    void issue() const;
+
+    /**
+     * @brief 本次绘制的三角形数（非三角形图元为 0）
+     */
+    uint32_t getTriangleCount() const;
+};
+
+class Mesh;
+class Shape;
+
+/**
+ * @brief 单个形状的内存占用（字节）
+ *
+ * 共享网格被多个形状引用，sharedGpuBytes/sharedCpuBytes 不应跨形状累加，
+ * 场景总量请用 MeshCache::getGpuBytes()/getCpuBytes() 统计一次。
+ */
+struct ShapeMemoryUsage {
+    size_t cpuBytes = 0;        // 对象本身及独占的堆内存（含独占网格保留的 CPU 副本）
+    size_t gpuBytes = 0;        // 独占的顶点/索引缓冲
+    size_t sharedCpuBytes = 0;  // 引用的共享网格保留的 CPU 副本
+    size_t sharedGpuBytes = 0;  // 引用的共享网格的顶点/索引缓冲
+
+    ShapeMemoryUsage& operator+=(const ShapeMemoryUsage& other) {
+        cpuBytes += other.cpuBytes;
+        gpuBytes += other.gpuBytes;
+        sharedCpuBytes += other.sharedCpuBytes;
+        sharedGpuBytes += other.sharedGpuBytes;
+        return *this;
+    }
+};
+
+/**
+ * @brief 形状观察者：世界包围体改变或形状析构时得到通知（例如用于维护 BVH）
+ */
+class ShapeObserver {
+public:
+    virtual ~ShapeObserver() = default;
+
+    /**
+     * @brief 形状的世界包围体已改变（在 Shape::flushTransforms() 中统一通知，每个形状至多一次）
+     */
+    virtual void onBoundsChanged(Shape& shape) = 0;
+
+    /**
+     * @brief 形状即将析构
+     */
+    virtual void onShapeDestroyed(Shape& shape) = 0;
+};
 
 // 基础图形类
 class Shape {
@@ -19,15 +88,27 @@ public:
      *
      * 约定：着色器需包含以下 uniform：
      *  - mat4 model    : 模型变换矩阵（由 getModelMatrix() 提供）
-     *  - mat4 view     : 视图矩阵（由摄像机提供，在外部上传）
-     *  - mat4 projection: 投影矩阵（由摄像机提供，在外部上传）
-     *  - vec3 color    : 顶点/片段颜色（在 draw 内部上传）
+     *  - FrameData block: 视图/投影矩阵等每帧数据（由 Window 写入 UBO）
+     *
+     * 默认实现：上传 model，绑定 getDrawCommand() 给出的 VAO，绘制后解绑。
+     * 批量绘制请使用 RenderQueue，它会合并相同状态以减少绑定次数。
+     */
+    virtual void draw(Shader& shader);
+
+    /**
+     * @brief 获取该形状的绘制命令（VAO、图元类型与数量）
+     * @return 绘制命令
      */
-    virtual void draw(Shader& shader) = 0;
-    virtual ~Shape() = default;
+    virtual DrawCommand getDrawCommand() const = 0;
+
+    virtual ~Shape();
+
+    // 形状持有 GPU 资源并登记在父子层次与观察者中，不可复制
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
     
     /**
-     * @brief 设置位置（世界坐标）
+     * @brief 设置位置（父节点空间；无父节点时即世界坐标）
      * @param position 三维位置向量 (x, y, z)
      */
     void setPosition(const glm::vec3& position);
@@ -52,14 +133,159 @@ public:
     
     /**
      * @brief 获取模型矩阵（用于上传到 shader 的 model uniform）
-     * @return 4x4 模型变换矩阵
+     * @return 4x4 模型变换矩阵（含网格固有尺寸）
+     *
+     * 矩阵被缓存，只有变换或祖先的变换改变后才会重新计算。
+     */
+    const glm::mat4& getModelMatrix() const;
+
+    /**
+     * @brief 获取法线矩阵（与模型矩阵一起缓存，用于 normalMatrix uniform）
+     */
+    const glm::mat3& getNormalMatrix() const;
+
+    /**
+     * @brief 获取世界变换（不含网格固有尺寸，子节点在此基础上变换）
      */
-    glm::mat4 getModelMatrix() const;
+    const glm::mat4& getWorldTransform() const;
+
+    /**
+     * @brief 由模型矩阵计算法线矩阵
+     * @param model 模型矩阵
+     * @return 均匀缩放时直接取左上 3x3（省去求逆），否则为逆转置；结果未归一化，由着色器归一化法线
+     */
+    static glm::mat3 computeNormalMatrix(const glm::mat4& model);
+
+    /**
+     * @brief 设置父节点，之后的位置/旋转/缩放相对于父节点
+     * @param parent 父节点；nullptr 表示脱离父节点
+     * @return 会形成环时不做修改并返回 false
+     */
+    bool setParent(Shape* parent);
+
+    Shape* getParent() const { return m_parent; }
+    const std::vector<Shape*>& getChildren() const { return m_children; }
+
+    /**
+     * @brief 获取局部包围盒（网格空间，未乘 m_meshScale）
+     */
+    const AABB& getLocalBounds() const { return m_localBounds; }
+
+    /**
+     * @brief 获取世界空间包围盒（变换改变后在第一次读取时重新计算）
+     */
+    const AABB& getWorldBounds() const;
+
+    /**
+     * @brief 获取世界空间包围球（与包围盒一起更新）
+     */
+    const BoundingSphere& getWorldSphere() const;
+
+    /**
+     * @brief 处理自上次调用以来变换或包围盒改变的形状：更新世界包围体并通知观察者
+     *
+     * 修改变换只设置脏标记并把形状加入待处理队列，一帧内多次修改（或修改父节点）
+     * 只在这里计算并通知一次。Window 每帧在剔除之前调用。
+     */
+    static void flushTransforms();
+
+    /**
+     * @brief 设置观察者（每个形状至多一个，传 nullptr 取消）
+     */
+    void setObserver(ShapeObserver* observer) { m_observer = observer; }
+    ShapeObserver* getObserver() const { return m_observer; }
+
+    /**
+     * @brief 获取用于软件遮挡剔除的三角形（局部空间，与 getModelMatrix() 配合使用）
+     * @param vertices 输出：顶点（追加前会清空）
+     * @param indices 输出：三角形索引
+     * @return 该形状可以作为遮挡体时返回 true
+     */
+    virtual bool getOccluderGeometry(std::vector<glm::vec3>& /*vertices*/, std::vector<uint32_t>& /*indices*/) const {
+        return false;
+    }
+
+    /**
+     * @brief 按屏幕尺寸选择细节层级（默认无 LOD）
+     * @param cameraPosition 摄像机世界坐标
+     * @param pixelsPerUnit 距离为 1 处一个世界单位对应的像素数；+inf 表示强制最高细节
+     * @return 相比最高细节本帧少绘制的三角形数
+     */
+    virtual uint32_t updateLOD(const glm::vec3& /*cameraPosition*/, float /*pixelsPerUnit*/) { return 0; }
+
+    /**
+     * @brief 统计该形状的内存占用
+     */
+    virtual ShapeMemoryUsage getMemoryUsage() const;
+
+    /**
+     * @brief 标记为遮挡体（仅对提供 getOccluderGeometry 的形状有效）
+     */
+    void setOccluder(bool occluder) { m_isOccluder = occluder; }
+    bool isOccluder() const { return m_isOccluder; }
 
 protected:
+    /**
+     * @brief 设置局部包围盒并标记世界包围体需要更新，由子类在构造时调用
+     * @param bounds 网格空间的包围盒
+     */
+    void setLocalBounds(const AABB& bounds);
+
+    /**
+     * @brief 设置网格固有尺寸（共享单位网格时由子类在构造时调用）
+     */
+    void setMeshScale(const glm::vec3& meshScale);
+
     glm::vec3 m_position;
     glm::vec3 m_rotation;  // 欧拉角：pitch, yaw, roll（度）
     glm::vec3 m_scale;
+    glm::vec3 m_meshScale; // 网格固有尺寸（共享单位网格时的半径/边长），与 m_scale 相乘
+
+    AABB m_localBounds;             // 局部包围盒
+
+private:
+    /**
+     * @brief 本节点及其子树的世界变换失效：只设置脏标记并排队等待通知
+     */
+    void invalidateTransform();
+
+    /**
+     * @brief 世界包围体失效，加入待处理队列（已在队列中时无操作）
+     */
+    void invalidateBounds();
+
+    /**
+     * @brief 按当前变换重新计算世界包围盒与包围球
+     */
+    void updateWorldBounds() const;
+
+    /**
+     * @brief 按脏标记重新计算缓存的矩阵
+     */
+    void updateMatrices() const;
+
+    ShapeObserver* m_observer = nullptr;
+    bool m_isOccluder = false;
+
+    // 变换层次
+    Shape* m_parent = nullptr;
+    std::vector<Shape*> m_children;
+
+    // 缓存的矩阵：local = T * R * S，world = parent.world * local，model = world * S(meshScale)
+    mutable glm::mat4 m_localMatrix = glm::mat4(1.0f);
+    mutable glm::mat4 m_worldMatrix = glm::mat4(1.0f);
+    mutable glm::mat4 m_modelMatrix = glm::mat4(1.0f);
+    mutable glm::mat3 m_normalMatrix = glm::mat3(1.0f);
+    mutable bool m_localDirty = true;   // 位置/旋转/缩放改变
+    mutable bool m_worldDirty = true;   // 本节点或祖先的变换改变
+
+    // 缓存的世界包围体
+    mutable AABB m_worldBounds;
+    mutable BoundingSphere m_worldSphere;
+    mutable bool m_boundsDirty = true;  // 世界包围体需要重新计算
+    bool m_boundsQueued = false;        // 已在待处理队列中，等待 flushTransforms() 通知观察者
+
+    static std::vector<Shape*> s_pendingBounds;  // 等待通知观察者的形状
 };
 
 // 带颜色的基础图形类
@@ -71,6 +297,15 @@ public:
      */
     ColoredShape(const glm::vec3& color);
 
+    /**
+     * @brief 绘制形状：先把颜色设为通用顶点属性（location 2），再按 Shape::draw 绘制
+     * @param shader 当前使用的着色器对象引用
+     *
+     * 顶点流中不含颜色的网格（如共享的单位网格）由此获得颜色；
+     * 对启用了 location 2 顶点数组的 VAO 无影响。
+     */
+    virtual void draw(Shader& shader) override;
+
     /**
      * @brief 设置颜色
      * @param color 颜色向量 (r,g,b)
@@ -100,15 +335,16 @@ public:
     Point(float x, float y, float z, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
 
     /**
-     * @brief 绘制点
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制点的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Point();
     
     glm::vec3 getPosition() const { return this->position; }
 private:
     GLuint VAO, VBO;
+    VertexFormat m_format;      // 顶点缓冲的格式
     glm::vec3 position;
 };
 
@@ -142,14 +378,23 @@ public:
          const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
 
     /**
-     * @brief 绘制线段
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制线段的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+
+    /**
+     * @brief 修改端点，只上传发生变化的端点
+     */
+    void setEndpoints(const glm::vec3& start, const glm::vec3& end);
+    const glm::vec3& getStart() const { return startPoint; }
+    const glm::vec3& getEnd() const { return endPoint; }
+
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Line();
     
 private:
     GLuint VAO, VBO;
+    VertexFormat m_format;      // 顶点缓冲的格式（坐标超出范围时会被放宽）
     glm::vec3 startPoint;
     glm::vec3 endPoint;
 };
@@ -177,14 +422,36 @@ public:
     );
 
     /**
-     * @brief 绘制三角形
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制三角形的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+
+    /**
+     * @brief 遮挡体几何：三角形的三角形
+     */
+    virtual bool getOccluderGeometry(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const override;
+
+    /**
+     * @brief 修改一段顶点，只用 glBufferSubData 上传这段顶点（法线改变时上传全部 3 个顶点）
+     * @param first 起始顶点下标
+     * @param positions 新位置
+     * @param count 顶点数，first + count 不超过 3
+     */
+    void setVertices(int first, const glm::vec3* positions, int count);
+
+    /**
+     * @brief 修改单个顶点
+     */
+    void setVertex(int index, const glm::vec3& position);
+    const glm::vec3& getVertex(int index) const { return vertices[index]; }
+
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Triangle();
     
 private:
     GLuint VAO, VBO;
+    VertexFormat m_format;      // 顶点缓冲的格式（坐标超出范围时会被放宽）
+    glm::vec3 m_normal;         // 面法线
     glm::vec3 vertices[3];      // 顶点
 };
 
@@ -192,7 +459,7 @@ private:
 class Quad : public ColoredShape {
 public:
     /**
-     * @brief 构造四边形（用四个顶点）
+     * @brief 构造四边形（用四个顶点，按多边形顺序给出，逆时针为正面）
      */
     Quad(float x1, float y1, float z1,
          float x2, float y2, float z2,
@@ -200,18 +467,40 @@ public:
          float x4, float y4, float z4,
          const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
     
-    Quad(Point p1, Point p2, Point p3, Point p4,
+    Quad(const Point& p1, const Point& p2, const Point& p3, const Point& p4,
          const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
 
     /**
-     * @brief 绘制四边形
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制四边形的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+
+    /**
+     * @brief 遮挡体几何：四边形的三角形
+     */
+    virtual bool getOccluderGeometry(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const override;
+
+    /**
+     * @brief 修改一段顶点，只用 glBufferSubData 上传这段顶点（法线改变时上传全部 4 个顶点）
+     * @param first 起始顶点下标
+     * @param positions 新位置
+     * @param count 顶点数，first + count 不超过 4
+     */
+    void setVertices(int first, const glm::vec3* positions, int count);
+
+    /**
+     * @brief 修改单个顶点
+     */
+    void setVertex(int index, const glm::vec3& position);
+    const glm::vec3& getVertex(int index) const { return vertices[index]; }
+
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Quad();
     
 private:
-    GLuint VAO, VBO;
+    GLuint VAO, VBO, EBO;
+    VertexFormat m_format;      // 顶点缓冲的格式（坐标超出范围时会被放宽）
+    glm::vec3 m_normal;         // 面法线
     glm::vec3 vertices[4];
 };
 
@@ -226,10 +515,14 @@ public:
     Cube(float size, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
 
     /**
-     * @brief 绘制立方体
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制立方体的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+
+    /**
+     * @brief 遮挡体几何：立方体的三角形
+     */
+    virtual bool getOccluderGeometry(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const override;
 
     /**
      * @brief 改变立方体的姿态。TODO：完成该支持。
@@ -237,16 +530,22 @@ public:
      */
     void transpose(const glm::vec3& pose);
 
+    /**
+     * @brief 内存占用：共享的单位立方体计入 shared 字段
+     */
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Cube();
 
-private:
-    GLuint VAO, VBO;
-
-    // 顶点
-    std::vector<float> vertices;
+    /**
+     * @brief 生成立方体顶点数据（36 个顶点，非索引）
+     * @param size 立方体边长
+     * @return 交错的顶点数据：位置(3) + 法线(3)
+     */
+    static std::vector<float> generateVertices(float size);
 
-    // 姿态，TODO: 加入姿态变换支持。
-    std::vector<float> pose;
+private:
+    // 共享的单位立方体网格，边长折算进 m_meshScale
+    std::shared_ptr<Mesh> m_mesh;
 };
 
 // 球体类
@@ -262,16 +561,93 @@ public:
     Sphere(float radius, int sectors = 36, int stacks = 18, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f));
 
     /**
-     * @brief 绘制球体
-     * @param shader 着色器引用，用于设置 model 与 color uniform
+     * @brief 获取绘制球体的命令
      */
-    virtual void draw(Shader& shader) override;
+    virtual DrawCommand getDrawCommand() const override;
+
+    /**
+     * @brief 内存占用：共享的各级 LOD 网格计入 shared 字段，写时复制后的独占网格计入自身
+     */
+    virtual ShapeMemoryUsage getMemoryUsage() const override;
     virtual ~Sphere();
 
+    /**
+     * @brief 按投影后的屏幕半径选择细节层级（带滞回，避免在阈值附近来回切换）
+     */
+    virtual uint32_t updateLOD(const glm::vec3& cameraPosition, float pixelsPerUnit) override;
+
+    /**
+     * @brief 当前细节层级（0 为构造时指定的最高细节）
+     */
+    int getLODLevel() const { return m_lodLevel; }
+
+    static constexpr int LOD_COUNT = 4;             // 细节层级数，每级经纬分段减半
+    static constexpr float LOD_HYSTERESIS = 0.15f;  // 切换阈值的滞回比例
+
+    /**
+     * @brief 每一级所需的最小屏幕半径（像素）
+     */
+    static const float LOD_MIN_RADIUS[LOD_COUNT];
+
+    /**
+     * @brief 单位球在屏幕上的半径（像素）
+     * @param model 单位球的模型矩阵（半径已折算进缩放）
+     * @param cameraPosition 摄像机世界坐标
+     * @param pixelsPerUnit 距离为 1 处一个世界单位对应的像素数
+     * @return 球半径取模型矩阵的最大轴向缩放；摄像机在球内时为 +inf
+     */
+    static float computeScreenRadius(const glm::mat4& model, const glm::vec3& cameraPosition, float pixelsPerUnit);
+
+    /**
+     * @brief 按屏幕半径选择细节层级（带滞回，避免在阈值附近来回切换）
+     * @param currentLevel 当前层级
+     * @param screenRadius 屏幕半径（像素）
+     * @return 新的层级
+     */
+    static int selectLOD(int currentLevel, float screenRadius);
+
+    /**
+     * @brief 某一细节层级的共享单位球网格（经纬分段按层级减半，来自 MeshCache）
+     */
+    static std::shared_ptr<Mesh> getLODMesh(int sectors, int stacks, int level);
+
+    /**
+     * @brief 生成球体网格（按经纬分段）
+     * @param radius 球半径
+     * @param sectors 经向分段数
+     * @param stacks 纬向分段数
+     * @param vertices 输出：交错的顶点数据，位置(3) + 法线(3)
+     * @param indices 输出：三角形索引
+     */
+    static void generateMesh(float radius, int sectors, int stacks,
+                             std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
+    /**
+     * @brief 修改一段顶点（单位球空间，半径仍由模型矩阵折算），只上传这段顶点
+     *
+     * 第一次修改时复制共享网格（写时复制），之后该球体独占网格并停用 LOD。
+     * @param first 起始顶点下标（顺序与 getVertices() 相同）
+     * @param vertices 交错的顶点数据：位置(3) + 法线(3)
+     */
+    void updateVertices(size_t first, const std::vector<float>& vertices);
+
+    /**
+     * @brief 复制共享网格，之后可通过 getVertices() 读取顶点（已独占时无操作）
+     */
+    void detachMesh();
+
+    /**
+     * @brief 独占网格的顶点数据，位置(3) + 法线(3)；仍共享网格时为空
+     *
+     * 共享网格默认在上传后释放 CPU 副本（见 Mesh::setDefaultResidency），需要时先 detachMesh()。
+     */
+    const std::vector<float>& getVertices() const;
+
 private:
-    GLuint VAO, VBO, EBO;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+    std::shared_ptr<Mesh> m_uniqueMesh;     // 写时复制后独占的网格（保留 CPU 副本）
+    // 共享的单位球网格（按细分参数缓存），半径折算进 m_meshScale；下标为细节层级
+    std::shared_ptr<Mesh> m_lodMeshes[LOD_COUNT];
+    int m_lodLevel = 0;
     int sectorCount;
     int stackCount;
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 顶点位置的存储格式
+enum class PositionFormat {
+    FLOAT32 = 0,    // 3 x float，12 字节
+    HALF_FLOAT,     // 3 x half + 2 字节填充，8 字节（约 3 位有效数字）
+    SNORM16         // 3 x snorm16 + 2 字节填充，8 字节（只适用于 [-1, 1] 内的单位网格）
+};
+
+// 顶点法线的存储格式
+enum class NormalFormat {
+    FLOAT32 = 0,    // 3 x float，12 字节
+    INT_2_10_10_10  // 10:10:10:2 打包的 snorm，4 字节
+};
+
+/**
+ * @brief 顶点格式：位置 + 法线的编码方式
+ *
+ * 颜色不在顶点流中（通用顶点属性 location 2），因此压缩格式每个顶点 12 字节，
+ * 而全 float 为 24 字节。所有格式都在当前 VAO 上绑定为 location 0（vec3 位置）
+ * 与 location 1（vec3 法线），着色器无需改动。
+ */
+struct VertexFormat {
+    PositionFormat position = PositionFormat::SNORM16;
+    NormalFormat normal = NormalFormat::INT_2_10_10_10;
+
+    bool operator==(const VertexFormat& other) const {
+        return position == other.position && normal == other.normal;
+    }
+
+    size_t getPositionSize() const;
+    size_t getNormalSize() const;
+    size_t getStride() const { return getPositionSize() + getNormalSize(); }
+
+    static constexpr float HALF_MAX = 65504.0f;    // 半精度可表示的最大有限值
+
+    /**
+     * @brief 按坐标范围选择可用的格式：SNORM16 超出 [-1, 1]、HALF_FLOAT 超出半精度范围时改用 FLOAT32
+     * @param maxAbs 顶点坐标绝对值的最大值
+     */
+    VertexFormat forRange(float maxAbs) const;
+
+    /**
+     * @brief 把交错的 float 顶点（位置(3) + 法线(3)）编码为本格式
+     * @return 可直接上传的顶点数据
+     */
+    std::vector<uint8_t> encode(const std::vector<float>& vertices) const;
+
+    /**
+     * @brief 在当前绑定的 VAO 上设置 location 0、1 的属性指针（需已绑定顶点缓冲）
+     */
+    void setupAttributes() const;
+
+    /**
+     * @brief 新建网格与图元使用的默认格式（已创建的网格不受影响）
+     */
+    static VertexFormat getDefault();
+    static void setDefault(const VertexFormat& format);
+
+    /**
+     * @brief 全 float 格式（与压缩前的布局一致）
+     */
+    static VertexFormat full() { return VertexFormat{ PositionFormat::FLOAT32, NormalFormat::FLOAT32 }; }
+};
+
+/**
+ * @brief float 转 IEEE 754 半精度（就近舍入，溢出为无穷）
+ */
+uint16_t floatToHalf(float value);
+
+/**
+ * @brief 单位向量打包为 GL_INT_2_10_10_10_REV（x 在低位，w 为 0）
+ */
+uint32_t packSnorm1010102(const glm::vec3& v);
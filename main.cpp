@@ -1,5 +1,8 @@
 #include <iostream>
 #include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -8,6 +11,7 @@
 
 #include "glwindow.hpp"
 #include "shapes.hpp"
+#include "instancing.hpp"
 #include "shader.hpp"
 #include "camera.hpp"
 #include "light.hpp"
@@ -28,16 +32,65 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     g_camera->processMouseCallback(xpos, ypos);
 }
 
-int main() {
+/**
+ * @brief 打印命令行用法
+ */
+static void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [--headless] [--frames N] [--dump PATTERN] [--dump-every N] [--size WxH] [--trace FILE]\n"
+              << "  --headless      render offscreen without a display\n"
+              << "  --frames N      stop after N frames (0 = until closed)\n"
+              << "  --dump PATTERN  save frames as PPM; PATTERN holds one %d for the frame number, e.g. frames/frame_%04d.ppm\n"
+              << "  --dump-every N  save every N-th frame\n"
+              << "  --size WxH      window / offscreen framebuffer size\n"
+              << "  --trace FILE    write a Chrome trace to FILE on exit (needs ENABLE_TRACING)\n";
+}
+
+int main(int argc, char** argv) {
+    int width = 1024, height = 768;
+    HeadlessConfig headless;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--headless") == 0) {
+            headless.enabled = true;
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            headless.frameCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--dump") == 0 && hasValue) {
+            headless.dumpPattern = argv[++i];
+        } else if (std::strcmp(arg, "--dump-every") == 0 && hasValue) {
+            headless.dumpInterval = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--trace") == 0 && hasValue) {
+            Trace::setOutputOnExit(argv[++i]);
+#if !defined(ENGINE_TRACING)
+            std::cerr << "Tracing is disabled at compile time; configure with -DENABLE_TRACING=ON\n";
+#endif
+        } else if (std::strcmp(arg, "--size") == 0 && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                print_usage(argv[0]);
+                return -1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : -1;
+        }
+    }
+    // 无显示模式下不指定帧数时会一直运行，默认只渲染一帧
+    if (headless.enabled && headless.frameCount == 0) headless.frameCount = 1;
+
     try {
         // 创建窗口
-        Window window(1024, 768, "OpenGL 3D Engine");
+        Window window(width, height, "OpenGL 3D Engine", headless);
 
         // 创建着色器程序
         Shader shader("shaders/vertex.glsl", "shaders/fragment.glsl");
         shader.use();
         window.BindShader(&shader);
 
+        // 延迟着色：几何阶段复用顶点着色器，光照解析为全屏绘制
+        Shader gbufferShader("shaders/vertex.glsl", "shaders/gbuffer_fragment.glsl");
+        Shader deferredShader("shaders/deferred_vertex.glsl", "shaders/deferred_fragment.glsl");
+        window.BindDeferredShaders(&gbufferShader, &deferredShader);
+
         // 创建摄像机并设置为全局供回调使用
         Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
         camera.setPerspective(45.0f, 0.1f, 100.0f);
@@ -45,9 +98,11 @@ int main() {
         g_camera = &camera;
         window.BindCamera(&camera); // 绑定摄像机到窗口
 
-        // 设置鼠标回调（需要 GLFWwindow*）
-        window.SetInputMode(GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        window.SetCursorPosCallback(mouse_callback);
+        // 设置鼠标回调（需要 GLFWwindow*）；无显示模式下没有输入
+        if (!window.IsHeadless()) {
+            window.SetInputMode(GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+            window.SetCursorPosCallback(mouse_callback);
+        }
         
         // 可根据个人习惯初始化鼠标反向（如需默认反向可取消注释）
         float lastFrame = 0.0f;
@@ -77,13 +132,25 @@ int main() {
         
         Quad* back_white = new Quad(
             0.0f, 0.0f, 0.0f,
+            4.0f, 0.0f, 0.0f,
             4.0f, 4.0f, 0.0f,
             0.0f, 4.0f, 0.0f,
-            4.0f, 0.0f, 0.0f,
             glm::vec3(1.0f, 1.0f, 1.0f)
         );
+        back_white->setOccluder(true); // 作为软件遮挡剔除的遮挡体
         window.AddShape(back_white);
 
+        // 实例化球体阵列：所有球共享一份网格，一次绘制调用
+        SphereBatch* sphereGrid = new SphereBatch(0.1f, 16, 8);
+        for (int i = 0; i < 10; ++i) {
+            for (int j = 0; j < 10; ++j) {
+                glm::vec3 position(-2.0f + i * 0.45f, -1.5f, -2.0f + j * 0.45f);
+                glm::vec3 color(i / 9.0f, 0.5f, j / 9.0f);
+                sphereGrid->addInstance(position, color);
+            }
+        }
+        window.AddInstanceBatch(sphereGrid);
+
         // 创建光源
         Sphere* sun = new Sphere(0.5f);
         sun->setPosition(glm::vec3(1.2f, -2.0f, 2.0f));
@@ -0,0 +1,129 @@
+#version 330 core
+// 延迟着色光照解析：从 G-buffer 重建位置与法线，一次全屏绘制累加所有光源
+out vec4 FragColor;
+
+#define MAX_LIGHTS 128  // 需与 light_buffer.hpp 中的 MAX_LIGHTS 一致
+
+// 光源结构（std140，与 GPULight 一致）
+struct Light {
+    vec4 positionType;          // xyz：位置，w：类型（0=点光源, 1=方向光, 2=聚光灯）
+    vec4 directionCutOff;       // xyz：方向，w：聚光灯内切光角余弦
+    vec4 ambientOuterCutOff;    // xyz：环境光，w：聚光灯外切光角余弦
+    vec4 diffuse;               // xyz：漫反射
+    vec4 specular;              // xyz：镜面反射
+    vec4 attenuation;           // x：常数项，y：一次项，z：二次项，w：影响半径
+};
+
+// 每帧数据（std140，绑定点 0，与顶点着色器共享）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 time;
+};
+
+// 全部光源（std140，绑定点 1，每帧上传一次）
+layout (std140) uniform LightData {
+    ivec4 lightCount;           // x：有效光源数
+    Light lights[MAX_LIGHTS];
+};
+
+// G-buffer（纹理单元见 gbuffer.hpp）
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormalShininess;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;
+
+in vec2 TexCoord;
+
+// 八面体编码的逆变换
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+// 计算单个光源的 Phong 光照
+vec3 calcLight(Light light, vec3 fragPos, vec3 norm, vec3 viewDir, vec3 objectColor, vec3 specularColor, float shininess)
+{
+    int type = int(light.positionType.w);
+    vec3 position = light.positionType.xyz;
+    vec3 direction = light.directionCutOff.xyz;
+
+    // 环境光
+    vec3 ambient = light.ambientOuterCutOff.xyz * objectColor;
+    
+    // 根据光源类型计算光线方向
+    vec3 lightDir;
+    if (type == 1) { // 方向光
+        lightDir = normalize(-direction);
+    } else { // 点光源或聚光灯
+        lightDir = normalize(position - fragPos);
+    }
+    
+    // 漫反射
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = light.diffuse.xyz * (diff * objectColor);
+    
+    // 镜面反射
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = light.specular.xyz * (spec * specularColor);
+    
+    // 衰减计算（仅对点光源和聚光灯）
+    float attenuation = 1.0;
+    if (type == 0 || type == 2) { // 点光源或聚光灯
+        float distance = length(position - fragPos);
+        attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + 
+                             light.attenuation.z * (distance * distance));
+    }
+    
+    // 聚光灯强度（仅对聚光灯）
+    float spotlightIntensity = 1.0;
+    if (type == 2) { // 聚光灯
+        float cutOff = light.directionCutOff.w;
+        float outerCutOff = light.ambientOuterCutOff.w;
+        float theta = dot(lightDir, normalize(-direction)); 
+        float epsilon = cutOff - outerCutOff;
+        spotlightIntensity = clamp((theta - outerCutOff) / epsilon, 0.0, 1.0);
+    }
+    
+    // 应用衰减和聚光灯强度
+    ambient  *= attenuation;
+    diffuse  *= attenuation * spotlightIntensity;
+    specular *= attenuation * spotlightIntensity;
+    
+    return ambient + diffuse + specular;
+}
+
+void main()
+{
+    float depth = texture(gDepth, TexCoord).r;
+    if (depth == 1.0) {
+        discard; // 背景，保留默认帧缓冲的清除颜色
+    }
+
+    // 由深度重建世界坐标
+    vec4 clip = vec4(TexCoord * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = inverseViewProjection * clip;
+    vec3 fragPos = world.xyz / world.w;
+
+    vec4 albedoSpecular = texture(gAlbedoSpecular, TexCoord);
+    vec4 normalShininess = texture(gNormalShininess, TexCoord);
+    vec3 objectColor = albedoSpecular.rgb;
+    vec3 specularColor = vec3(albedoSpecular.a);
+    vec3 norm = octDecode(normalShininess.xy * 2.0 - 1.0);
+    float shininess = normalShininess.z * 256.0;
+    vec3 viewDir = normalize(cameraPosition.xyz - fragPos);
+
+    vec3 result = vec3(0.0);
+    int count = min(lightCount.x, MAX_LIGHTS);
+    for (int i = 0; i < count; ++i) {
+        result += calcLight(lights[i], fragPos, norm, viewDir, objectColor, specularColor, shininess);
+    }
+    FragColor = vec4(result, 1.0);
+}
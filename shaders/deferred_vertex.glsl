@@ -0,0 +1,10 @@
+#version 330 core
+// 全屏三角形：顶点由 gl_VertexID 生成，无需顶点缓冲
+out vec2 TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -1,6 +1,8 @@
 #version 330 core
 out vec4 FragColor;
 
+#define MAX_LIGHTS 128  // 需与 light_buffer.hpp 中的 MAX_LIGHTS 一致
+
 // 材质属性
 struct Material {
     vec3 ambient;
@@ -9,34 +11,131 @@ struct Material {
     float shininess;
 };
 
-// 光源结构
+// 光源结构（std140，与 GPULight 一致）
 struct Light {
-    int type;              // 0=点光源, 1=方向光, 2=聚光灯
-    vec3 position;
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    
-    // 衰减参数
-    float constant;
-    float linear;
-    float quadratic;
-    
-    // 聚光灯参数
-    float cutOff;
-    float outerCutOff;
+    vec4 positionType;          // xyz：位置，w：类型（0=点光源, 1=方向光, 2=聚光灯）
+    vec4 directionCutOff;       // xyz：方向，w：聚光灯内切光角余弦
+    vec4 ambientOuterCutOff;    // xyz：环境光，w：聚光灯外切光角余弦
+    vec4 diffuse;               // xyz：漫反射
+    vec4 specular;              // xyz：镜面反射
+    vec4 attenuation;           // x：常数项，y：一次项，z：二次项，w：影响半径
+};
+
+// 每帧数据（std140，绑定点 0，与顶点着色器共享）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 time;
+};
+
+// 全部光源（std140，绑定点 1，每帧上传一次）
+layout (std140) uniform LightData {
+    ivec4 lightCount;           // x：有效光源数
+    Light lights[MAX_LIGHTS];
 };
 
 uniform Material material;
-uniform Light light;
-uniform vec3 viewPos;
 uniform int renderMode; // 渲染模式 uniform
+uniform int lightingMode; // 光照模式：0 遍历全部光源，1 分簇
+
+// 分簇光照数据（纹理缓冲，见 cluster_buffer.hpp）
+uniform samplerBuffer clusterLights;    // 每个光源 6 个纹素，与 Light 结构一致
+uniform usamplerBuffer clusterRanges;   // 每个簇的 (offset, count)
+uniform usamplerBuffer clusterIndices;  // 光源索引表
+uniform ivec3 clusterDims;              // 瓦片数 x、y 与深度切片数
+uniform vec2 clusterTileSize;           // 每个瓦片的像素尺寸
+uniform vec2 clusterSliceParams;        // slice = log(depth) * x + y
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec3 Color;
 
+// 计算单个光源的 Phong 光照
+vec3 calcLight(Light light, vec3 norm, vec3 viewDir, vec3 objectColor)
+{
+    int type = int(light.positionType.w);
+    vec3 position = light.positionType.xyz;
+    vec3 direction = light.directionCutOff.xyz;
+
+    // 环境光
+    vec3 ambient = light.ambientOuterCutOff.xyz * objectColor;
+    
+    // 根据光源类型计算光线方向
+    vec3 lightDir;
+    if (type == 1) { // 方向光
+        lightDir = normalize(-direction);
+    } else { // 点光源或聚光灯
+        lightDir = normalize(position - FragPos);
+    }
+    
+    // 漫反射
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = light.diffuse.xyz * (diff * objectColor);
+    
+    // 镜面反射
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    vec3 specular = light.specular.xyz * (spec * material.specular);
+    
+    // 衰减计算（仅对点光源和聚光灯）
+    float attenuation = 1.0;
+    if (type == 0 || type == 2) { // 点光源或聚光灯
+        float distance = length(position - FragPos);
+        attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + 
+                             light.attenuation.z * (distance * distance));
+    }
+    
+    // 聚光灯强度（仅对聚光灯）
+    float spotlightIntensity = 1.0;
+    if (type == 2) { // 聚光灯
+        float cutOff = light.directionCutOff.w;
+        float outerCutOff = light.ambientOuterCutOff.w;
+        float theta = dot(lightDir, normalize(-direction)); 
+        float epsilon = cutOff - outerCutOff;
+        spotlightIntensity = clamp((theta - outerCutOff) / epsilon, 0.0, 1.0);
+    }
+    
+    // 应用衰减和聚光灯强度
+    ambient  *= attenuation;
+    diffuse  *= attenuation * spotlightIntensity;
+    specular *= attenuation * spotlightIntensity;
+    
+    return ambient + diffuse + specular;
+}
+
+// 从纹理缓冲读取第 index 个光源
+Light fetchClusterLight(int index)
+{
+    int base = index * 6;
+    Light light;
+    light.positionType       = texelFetch(clusterLights, base + 0);
+    light.directionCutOff    = texelFetch(clusterLights, base + 1);
+    light.ambientOuterCutOff = texelFetch(clusterLights, base + 2);
+    light.diffuse            = texelFetch(clusterLights, base + 3);
+    light.specular           = texelFetch(clusterLights, base + 4);
+    light.attenuation        = texelFetch(clusterLights, base + 5);
+    return light;
+}
+
+// 累加当前片段所在簇的光源
+vec3 calcClusteredLights(vec3 norm, vec3 viewDir, vec3 objectColor)
+{
+    float depth = max(-(view * vec4(FragPos, 1.0)).z, 1e-4);
+    int slice = clamp(int(log(depth) * clusterSliceParams.x + clusterSliceParams.y), 0, clusterDims.z - 1);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterTileSize), ivec2(0), clusterDims.xy - 1);
+    int cluster = tile.x + clusterDims.x * (tile.y + clusterDims.y * slice);
+
+    uvec2 range = texelFetch(clusterRanges, cluster).xy;
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < range.y; ++i) {
+        int index = int(texelFetch(clusterIndices, int(range.x + i)).r);
+        result += calcLight(fetchClusterLight(index), norm, viewDir, objectColor);
+    }
+    return result;
+}
+
 void main()
 {
     // 根据不同的渲染模式显示不同的效果
@@ -51,55 +150,21 @@ void main()
         // 片段着色后结果 - 显示未光照计算的纯色
         FragColor = vec4(Color, 1.0);
     } else {
-        // 最终处理结果 - 完整的光照计算
+        // 最终处理结果 - 完整的光照计算，累加所有光源
         // 使用传入的颜色作为材质的基本颜色
         vec3 objectColor = Color;
-        
-        // 环境光
-        vec3 ambient = light.ambient * objectColor;
-        
-        // 漫反射
         vec3 norm = normalize(Normal);
-        vec3 lightDir;
-        
-        // 根据光源类型计算光线方向
-        if (light.type == 1) { // 方向光
-            lightDir = normalize(-light.direction);
-        } else { // 点光源或聚光灯
-            lightDir = normalize(light.position - FragPos);
-        }
-        
-        float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = light.diffuse * (diff * objectColor);
-        
-        // 镜面反射
-        vec3 viewDir = normalize(viewPos - FragPos);
-        vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-        vec3 specular = light.specular * (spec * material.specular);
-        
-        // 衰减计算（仅对点光源和聚光灯）
-        float attenuation = 1.0;
-        if (light.type == 0 || light.type == 2) { // 点光源或聚光灯
-            float distance = length(light.position - FragPos);
-            attenuation = 1.0 / (light.constant + light.linear * distance + 
-                                light.quadratic * (distance * distance));
-        }
-        
-        // 聚光灯强度（仅对聚光灯）
-        float spotlightIntensity = 1.0;
-        if (light.type == 2) { // 聚光灯
-            float theta = dot(lightDir, normalize(-light.direction)); 
-            float epsilon = light.cutOff - light.outerCutOff;
-            spotlightIntensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+        vec3 viewDir = normalize(cameraPosition.xyz - FragPos);
+
+        vec3 result = vec3(0.0);
+        if (lightingMode == 1) {
+            result = calcClusteredLights(norm, viewDir, objectColor);
+        } else {
+            int count = min(lightCount.x, MAX_LIGHTS);
+            for (int i = 0; i < count; ++i) {
+                result += calcLight(lights[i], norm, viewDir, objectColor);
+            }
         }
-        
-        // 应用衰减和聚光灯强度
-        ambient  *= attenuation;
-        diffuse  *= attenuation * spotlightIntensity;
-        specular *= attenuation * spotlightIntensity;
-        
-        vec3 result = ambient + diffuse + specular;
         FragColor = vec4(result, 1.0);
     }
-}
\ No newline at end of file
+}
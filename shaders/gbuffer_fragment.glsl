@@ -0,0 +1,35 @@
+#version 330 core
+// 延迟着色几何阶段：写入 G-buffer（与 vertex.glsl 搭配使用）
+layout (location = 0) out vec4 gAlbedoSpecular;   // rgb：反照率，a：镜面强度
+layout (location = 1) out vec4 gNormalShininess;  // rg：八面体编码法线，b：光泽度 / 256
+
+// 材质属性
+struct Material {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
+
+uniform Material material;
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec3 Color;
+
+// 单位向量的八面体编码，结果位于 [-1, 1]^2
+vec2 octEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0) {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return e;
+}
+
+void main()
+{
+    gAlbedoSpecular = vec4(Color, dot(material.specular, vec3(1.0 / 3.0)));
+    gNormalShininess = vec4(octEncode(normalize(Normal)) * 0.5 + 0.5, material.shininess / 256.0, 0.0);
+}
@@ -1,12 +1,23 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
+layout (location = 2) in vec3 aColor;           // 逐顶点颜色；实例化时为逐实例颜色
+layout (location = 3) in mat4 aInstanceModel;   // 实例化时的逐实例模型矩阵（占用 location 3~6）
+layout (location = 7) in mat3 aInstanceNormal;  // 实例化时的逐实例法线矩阵（占用 location 7~9）
+
+// 每帧数据（std140，绑定点 0，由 Window 每帧写入一次）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 time;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix; // CPU 端随模型矩阵计算的法线矩阵（未归一化，片段着色器中归一化）
 uniform int renderMode; // 渲染模式 uniform
+uniform bool useInstancing; // 是否使用逐实例模型矩阵
 
 out vec3 FragPos;
 out vec3 Normal;
@@ -14,9 +25,11 @@ out vec3 Color;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    mat4 modelMatrix = useInstancing ? aInstanceModel : model;
+    vec4 worldPos = modelMatrix * vec4(aPos, 1.0);
+    gl_Position = viewProjection * worldPos;
     
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(worldPos);
+    Normal = (useInstancing ? aInstanceNormal : normalMatrix) * aNormal;
     Color = aColor;
 }
\ No newline at end of file
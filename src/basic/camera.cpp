@@ -2,6 +2,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <cmath>
 
 Camera::Camera(const glm::vec3& position, const glm::vec3& up, float yaw, float pitch)
     : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(2.5f), MouseSensitivity(0.1f), Zoom(45.0f),
@@ -110,6 +111,14 @@ void Camera::toggleInvertY() {
     invertY = !invertY;
 }
 
+void Camera::lookAt(const glm::vec3& target) {
+    // updateCameraVectors 中 Front = (-cos(pitch)·sin(yaw), sin(pitch), -cos(pitch)·cos(yaw))，据此反解
+    glm::vec3 direction = glm::normalize(target - Position);
+    Pitch = glm::clamp(glm::degrees(std::asin(glm::clamp(direction.y, -1.0f, 1.0f))), -89.0f, 89.0f);
+    Yaw = glm::degrees(std::atan2(-direction.x, -direction.z));
+    updateCameraVectors();
+}
+
 bool Camera::isInvertX() const { return invertX; }
 
 bool Camera::isInvertY() const { return invertY; }
@@ -1,9 +1,28 @@
 #include <basic/shader.hpp>
+#include <basic/uniform_buffer.hpp>
+#include <basic/trace.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
+namespace {
+
+// FNV-1a 字符串哈希
+uint32_t hashName(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; ++name) {
+        hash ^= (uint8_t)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+    TRACE_ZONE("Shader::compile");
     // 1. 从文件路径中获取顶点/片段着色器源码
     std::string vertexCode;
     std::string fragmentCode;
@@ -64,26 +83,131 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // 删除着色器，它们已经链接到程序中了
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    // 3. 缓存 uniform 位置，并把约定的 uniform block 绑定到固定绑定点
+    cacheUniformLocations();
+    bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+    bindUniformBlock("LightData", LIGHT_DATA_BINDING);
 }
 
 void Shader::use() {
     glUseProgram(ID);
 }
 
+void Shader::cacheUniformLocations() {
+    m_uniforms.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> nameBuffer(maxLength + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0) continue;   // uniform block 中的成员没有位置
+
+        m_uniforms.push_back(UniformEntry{ hashName(name.c_str()), location, name });
+
+        // 数组：活动名为 "name[0]"，同时登记 "name" 与其余各元素
+        size_t bracket = name.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == name.size()) {
+            std::string base = name.substr(0, bracket);
+            m_uniforms.push_back(UniformEntry{ hashName(base.c_str()), location, base });
+            for (GLint k = 1; k < size; ++k) {
+                std::string element = base + "[" + std::to_string(k) + "]";
+                GLint elementLocation = glGetUniformLocation(ID, element.c_str());
+                m_uniforms.push_back(UniformEntry{ hashName(element.c_str()), elementLocation, element });
+            }
+        }
+    }
+
+    std::sort(m_uniforms.begin(), m_uniforms.end(),
+              [](const UniformEntry& a, const UniformEntry& b) { return a.hash < b.hash; });
+}
+
+UniformHandle Shader::getUniform(const char* name) const {
+    uint32_t hash = hashName(name);
+    auto it = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), hash,
+                               [](const UniformEntry& entry, uint32_t h) { return entry.hash < h; });
+    for (; it != m_uniforms.end() && it->hash == hash; ++it) {
+        if (std::strcmp(it->name.c_str(), name) == 0) {
+            return UniformHandle{ it->location };
+        }
+    }
+    return UniformHandle{};
+}
+
+bool Shader::bindUniformBlock(const char* blockName, GLuint binding) {
+    GLuint index = glGetUniformBlockIndex(ID, blockName);
+    if (index == GL_INVALID_INDEX) return false;
+    glUniformBlockBinding(ID, index, binding);
+    return true;
+}
+
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(getUniform(name.c_str()), value);
+}
+
+void Shader::setInt(const char* name, int value) const {
+    setInt(getUniform(name), value);
+}
+
+void Shader::setInt(UniformHandle handle, int value) const {
+    glUniform1i(handle.location, value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(getUniform(name.c_str()), value);
+}
+
+void Shader::setFloat(const char* name, float value) const {
+    setFloat(getUniform(name), value);
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const {
+    glUniform1f(handle.location, value);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec3(getUniform(name.c_str()), value);
+}
+
+void Shader::setVec3(const char* name, const glm::vec3 &value) const {
+    setVec3(getUniform(name), value);
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3 &value) const {
+    glUniform3fv(handle.location, 1, &value[0]);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(getUniform(name.c_str()), mat);
+}
+
+void Shader::setMat4(const char* name, const glm::mat4 &mat) const {
+    setMat4(getUniform(name), mat);
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
+    setMat3(getUniform(name.c_str()), mat);
+}
+
+void Shader::setMat3(const char* name, const glm::mat3 &mat) const {
+    setMat3(getUniform(name), mat);
+}
+
+void Shader::setMat3(UniformHandle handle, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(handle.location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::checkCompileErrors(unsigned int shader, std::string type) {
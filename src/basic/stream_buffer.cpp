@@ -0,0 +1,116 @@
+#include <basic/stream_buffer.hpp>
+#include <cstring>
+
+StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr regionSize) : m_target(target), m_regionSize(regionSize) {
+    glGenBuffers(1, &ID);
+    glBindBuffer(m_target, ID);
+
+    if (isPersistentMappingSupported()) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_target, m_regionSize * REGION_COUNT, nullptr, flags);
+        m_persistent = static_cast<uint8_t*>(glMapBufferRange(m_target, 0, m_regionSize * REGION_COUNT, flags));
+    }
+    if (!m_persistent) {
+        glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(m_target, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (m_persistent || m_mapped) {
+        glBindBuffer(m_target, ID);
+        glUnmapBuffer(m_target);
+        glBindBuffer(m_target, 0);
+    }
+    glDeleteBuffers(1, &ID);
+}
+
+void StreamBuffer::beginFrame() {
+    m_cursor = 0;
+
+    if (!m_persistent) {
+        // 孤立旧存储：GPU 仍在读的数据由驱动保留，新写入不会等待
+        glBindBuffer(m_target, ID);
+        glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(m_target, 0);
+        return;
+    }
+
+    m_region = (m_region + 1) % REGION_COUNT;
+    GLsync& fence = m_fences[m_region];
+    if (!fence) return;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        m_stalls++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+    if (!m_persistent) return;
+
+    GLsync& fence = m_fences[m_region];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLintptr StreamBuffer::reserve(GLsizeiptr size, GLsizeiptr alignment) {
+    GLsizeiptr offset = (m_cursor + alignment - 1) / alignment * alignment;
+    if (offset + size > m_regionSize) return -1;
+    m_cursor = offset + size;
+    return offset;
+}
+
+void* StreamBuffer::map(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset) {
+    GLintptr local = reserve(size, alignment);
+    if (local < 0) return nullptr;
+
+    if (m_persistent) {
+        offset = m_region * m_regionSize + local;
+        return m_persistent + offset;
+    }
+
+    // 本帧内各次写入互不重叠，存储又是刚孤立的，因此可以不同步映射
+    offset = local;
+    glBindBuffer(m_target, ID);
+    void* ptr = glMapBufferRange(m_target, offset, size,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    m_mapped = ptr != nullptr;
+    return ptr;
+}
+
+void StreamBuffer::unmap() {
+    if (!m_mapped) return;
+    glBindBuffer(m_target, ID);
+    glUnmapBuffer(m_target);
+    glBindBuffer(m_target, 0);
+    m_mapped = false;
+}
+
+GLintptr StreamBuffer::write(const void* data, GLsizeiptr size, GLsizeiptr alignment) {
+    GLintptr offset;
+    void* ptr = map(size, alignment, offset);
+    if (!ptr) return -1;
+    std::memcpy(ptr, data, size);
+    unmap();
+    return offset;
+}
+
+bool StreamBuffer::isPersistentMappingSupported() {
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+GLsizeiptr StreamBuffer::getUniformAlignment() {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment > 0 ? alignment : 256;
+}
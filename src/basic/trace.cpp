@@ -0,0 +1,255 @@
+#include <basic/trace.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+struct TraceChunk {
+    TraceEvent events[Trace::CHUNK_EVENTS];
+    std::atomic<size_t> count{ 0 };             // 已提交的事件数（写线程 release，导出线程 acquire）
+    std::atomic<TraceChunk*> next{ nullptr };
+};
+
+/**
+ * @brief 一个线程的事件缓冲；同一时刻只有一个线程写入
+ *
+ * 块组成 head → tail 的链表。块数达到上限后，写满的尾块之后接上回收的最早块（覆盖最旧的事件）。
+ * 换块（追加或回收）只在持有 mutex 时进行，导出线程遍历链表时也持有它，
+ * 因此正在被读取的块不会被回收；块内追加事件不加锁。
+ */
+struct ThreadBuffer {
+    ThreadBuffer() : head(new TraceChunk()), tail(head) {}
+    ~ThreadBuffer() {
+        for (TraceChunk* chunk = head; chunk;) {
+            TraceChunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    void append(const char* eventName, uint64_t start, uint64_t end) {
+        size_t index = tail->count.load(std::memory_order_relaxed);
+        if (index == Trace::CHUNK_EVENTS) {
+            nextChunk();
+            index = 0;
+        }
+        tail->events[index] = { eventName, start, end };
+        tail->count.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 尾块写满时换块：未达上限则新建，否则回收最早的块
+     */
+    void nextChunk() {
+        std::lock_guard<std::mutex> lock(mutex);
+        TraceChunk* chunk;
+        if (chunks < Trace::MAX_CHUNKS_PER_THREAD) {
+            chunk = new TraceChunk();
+            chunks++;
+        } else {
+            chunk = head;
+            head = chunk->next.load(std::memory_order_relaxed);
+            overwritten.fetch_add(chunk->count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            chunk->count.store(0, std::memory_order_relaxed);
+            chunk->next.store(nullptr, std::memory_order_relaxed);
+        }
+        tail->next.store(chunk, std::memory_order_release);
+        tail = chunk;
+    }
+
+    std::mutex mutex;               // 保护 head 与链表结构（换块、导出）
+    TraceChunk* head;
+    TraceChunk* tail;               // 只由写线程访问
+    size_t chunks = 1;
+    uint32_t id = 0;                // 时间线上的 tid
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t> overwritten{ 0 };  // 被覆盖的事件数
+    bool inUse = false;             // 受 Registry::mutex 保护
+};
+
+/**
+ * @brief 所有线程缓冲的登记表；只在线程第一次记录与退出时加锁
+ */
+struct Registry {
+    ~Registry() {
+        // 进程退出：静态对象析构时写出（此时其他线程应已结束）
+        if (exitPath.empty()) return;
+        if (Trace::writeChromeTrace(exitPath)) {
+            uint64_t overwritten = Trace::getDroppedCount();
+            if (overwritten) {
+                std::fprintf(stderr, "Trace buffer full: the oldest %llu events were overwritten and are missing from %s\n",
+                             (unsigned long long)overwritten, exitPath.c_str());
+            }
+        }
+    }
+
+    ThreadBuffer* acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& buffer : buffers) {
+            if (!buffer->inUse) {
+                buffer->inUse = true;
+                return buffer.get();
+            }
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* buffer = buffers.back().get();
+        buffer->id = (uint32_t)buffers.size();
+        buffer->inUse = true;
+        return buffer;
+    }
+
+    void release(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->inUse = false;
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::string exitPath;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief 线程局部的缓冲句柄：第一次使用时取得缓冲，线程退出时归还
+ */
+struct ThreadHandle {
+    ~ThreadHandle() {
+        if (buffer) registry().release(buffer);
+    }
+
+    ThreadBuffer* get() {
+        if (!buffer) buffer = registry().acquire();
+        return buffer;
+    }
+
+    ThreadBuffer* buffer = nullptr;
+};
+
+thread_local ThreadHandle t_thread;
+
+/**
+ * @brief 写出 JSON 字符串（转义引号、反斜杠与控制字符）
+ */
+void writeJsonString(std::FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if ((unsigned char)*c < 0x20) {
+            std::fprintf(file, "\\u%04x", (unsigned char)*c);
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+}  // namespace
+
+uint64_t Trace::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void Trace::record(const char* name, uint64_t start, uint64_t end) {
+    t_thread.get()->append(name, start, end);
+}
+
+void Trace::setThreadName(const char* name) {
+    t_thread.get()->name.store(name, std::memory_order_release);
+}
+
+bool Trace::writeChromeTrace(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "Failed to open %s for writing\n", path.c_str());
+        return false;
+    }
+
+    // 只复制缓冲指针列表；事件按各块已提交的数量读取，写线程可以同时继续追加
+    // （持有缓冲的 mutex 期间写线程不能换块，写满当前块时会等待导出完这个缓冲）
+    std::vector<ThreadBuffer*> buffers;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& buffer : reg.buffers) buffers.push_back(buffer.get());
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    uint64_t overwritten = 0;
+    for (ThreadBuffer* buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        overwritten += buffer->overwritten.load(std::memory_order_relaxed);
+        const char* threadName = buffer->name.load(std::memory_order_acquire);
+        if (threadName) {
+            std::fprintf(file, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": ",
+                         first ? "" : ",\n", buffer->id);
+            writeJsonString(file, threadName);
+            std::fprintf(file, "}}");
+            first = false;
+        }
+
+        for (TraceChunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                const TraceEvent& event = chunk->events[i];
+                std::fprintf(file, "%s{\"ph\": \"X\", \"name\": ", first ? "" : ",\n");
+                writeJsonString(file, event.name);
+                // Chrome trace 的时间单位为微秒
+                std::fprintf(file, ", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                             buffer->id, event.start / 1000.0, (event.end - event.start) / 1000.0);
+                first = false;
+            }
+        }
+    }
+    // 缓冲写满后被覆盖的事件数，记录在 otherData 中
+    std::fprintf(file, "\n], \"otherData\": {\"overwrittenEvents\": %llu}}\n", (unsigned long long)overwritten);
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+void Trace::setOutputOnExit(const std::string& path) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.exitPath = path;
+}
+
+size_t Trace::getEventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (TraceChunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            count += chunk->count.load(std::memory_order_acquire);
+        }
+    }
+    return count;
+}
+
+uint64_t Trace::getDroppedCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t dropped = 0;
+    for (auto& buffer : reg.buffers) dropped += buffer->overwritten.load(std::memory_order_relaxed);
+    return dropped;
+}
@@ -0,0 +1,20 @@
+#include <basic/uniform_buffer.hpp>
+
+UniformBuffer::UniformBuffer(GLsizeiptr size, GLuint binding) : m_binding(binding), m_size(size) {
+    glGenBuffers(1, &ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, ID);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &ID);
+}
+
+void UniformBuffer::update(const void* data, GLsizeiptr size, GLintptr offset) {
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
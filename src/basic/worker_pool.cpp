@@ -0,0 +1,93 @@
+#include <basic/worker_pool.hpp>
+#include <basic/trace.hpp>
+#include <algorithm>
+
+namespace {
+
+// 当前线程是否正在执行某个任务（用于嵌套调用时串行执行）
+thread_local bool t_insideTask = false;
+
+}  // namespace
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    m_threads.reserve(threadCount - 1);
+    for (unsigned t = 1; t < threadCount; ++t) {
+        m_threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) thread.join();
+}
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool instance;
+    return instance;
+}
+
+void WorkerPool::parallelFor(unsigned taskCount, const std::function<void(unsigned)>& task) {
+    if (taskCount == 0) return;
+    if (taskCount == 1 || m_threads.empty() || t_insideTask) {
+        for (unsigned i = 0; i < taskCount; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // 上一批次可能还有迟到的工作线程持有旧任务指针，等它们离开后才能重置计数器
+        m_done.wait(lock, [this]() { return m_busy == 0; });
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_finished = 0;
+        m_next.store(0, std::memory_order_relaxed);
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    unsigned finished = runTasks(task, taskCount);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished += finished;
+    m_done.wait(lock, [this]() { return m_finished == m_taskCount; });
+}
+
+void WorkerPool::workerLoop() {
+    TRACE_THREAD_NAME("worker");
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [&]() { return m_stop || m_generation != seen; });
+        if (m_stop) return;
+        seen = m_generation;
+        const std::function<void(unsigned)>* task = m_task;
+        unsigned taskCount = m_taskCount;
+        m_busy++;
+        lock.unlock();
+
+        unsigned finished = runTasks(*task, taskCount);
+
+        lock.lock();
+        m_busy--;
+        m_finished += finished;
+        m_done.notify_all();
+    }
+}
+
+unsigned WorkerPool::runTasks(const std::function<void(unsigned)>& task, unsigned taskCount) {
+    unsigned finished = 0;
+    t_insideTask = true;
+    for (unsigned i = m_next.fetch_add(1, std::memory_order_relaxed); i < taskCount;
+         i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+        task(i);
+        finished++;
+    }
+    t_insideTask = false;
+    return finished;
+}
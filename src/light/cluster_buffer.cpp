@@ -0,0 +1,83 @@
+#include <light/cluster_buffer.hpp>
+
+ClusterLightBuffer::ClusterLightBuffer(int tilesX, int tilesY, int slicesZ)
+    : m_clusterer(tilesX, tilesY, slicesZ) {
+    createTextureBuffer(m_lights, GL_RGBA32F);
+    createTextureBuffer(m_ranges, GL_RG32UI);
+    createTextureBuffer(m_indices, GL_R32UI);
+}
+
+ClusterLightBuffer::~ClusterLightBuffer() {
+    for (TextureBuffer* tbo : { &m_lights, &m_ranges, &m_indices }) {
+        glDeleteTextures(1, &tbo->texture);
+        glDeleteBuffers(1, &tbo->buffer);
+    }
+}
+
+void ClusterLightBuffer::createTextureBuffer(TextureBuffer& tbo, GLenum format) {
+    glGenBuffers(1, &tbo.buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, tbo.buffer);
+    // 纹理缓冲不能引用空的存储，先分配一个最小的缓冲
+    tbo.capacity = 64;
+    glBufferData(GL_TEXTURE_BUFFER, tbo.capacity, nullptr, GL_STREAM_DRAW);
+
+    glGenTextures(1, &tbo.texture);
+    glBindTexture(GL_TEXTURE_BUFFER, tbo.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, tbo.buffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusterLightBuffer::uploadTextureBuffer(TextureBuffer& tbo, const void* data, GLsizeiptr size) {
+    if (size == 0) return;
+    glBindBuffer(GL_TEXTURE_BUFFER, tbo.buffer);
+    if (size > tbo.capacity) {
+        // 扩容时重新分配存储，纹理引用的是缓冲对象本身，无需重新调用 glTexBuffer
+        tbo.capacity = size * 2;
+        glBufferData(GL_TEXTURE_BUFFER, tbo.capacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusterLightBuffer::update(const std::vector<Light*>& lights, const glm::mat4& view,
+                                float fovY, float aspect, float nearPlane, float farPlane) {
+    m_gpuLights.resize(lights.size());
+    m_viewSpheres.resize(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i) {
+        m_gpuLights[i] = lights[i]->toGPU();
+        glm::vec4 center = view * glm::vec4(lights[i]->position, 1.0f);
+        m_viewSpheres[i] = glm::vec4(center.x, center.y, center.z, m_gpuLights[i].attenuation.w);
+    }
+
+    m_clusterer.setProjection(fovY, aspect, nearPlane, farPlane);
+    m_clusterer.assign(m_viewSpheres);
+
+    const auto& ranges = m_clusterer.getClusterRanges();
+    const auto& indices = m_clusterer.getLightIndices();
+    uploadTextureBuffer(m_lights, m_gpuLights.data(), m_gpuLights.size() * sizeof(GPULight));
+    uploadTextureBuffer(m_ranges, ranges.data(), ranges.size() * sizeof(uint32_t));
+    uploadTextureBuffer(m_indices, indices.data(), indices.size() * sizeof(uint32_t));
+}
+
+void ClusterLightBuffer::bind(const Shader& shader, int viewportWidth, int viewportHeight) const {
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_LIGHTS_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_lights.texture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_RANGES_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_ranges.texture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_INDICES_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_indices.texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setInt("clusterLights", CLUSTER_LIGHTS_UNIT);
+    shader.setInt("clusterRanges", CLUSTER_RANGES_UNIT);
+    shader.setInt("clusterIndices", CLUSTER_INDICES_UNIT);
+
+    glUniform3i(shader.getUniform("clusterDims").location,
+                m_clusterer.getTilesX(), m_clusterer.getTilesY(), m_clusterer.getSlicesZ());
+    glUniform2f(shader.getUniform("clusterTileSize").location,
+                (float)viewportWidth / m_clusterer.getTilesX(), (float)viewportHeight / m_clusterer.getTilesY());
+    glUniform2f(shader.getUniform("clusterSliceParams").location,
+                m_clusterer.getSliceScale(), m_clusterer.getSliceBias());
+}
@@ -1,31 +1,105 @@
 #include <light/light.hpp>
+#include <light/light_cluster.hpp>
+#include <basic/trace.hpp>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstdio>
+#include <limits>
 #include <string>
 
+namespace {
+
+// 拼接 "name.field" 到栈上缓冲区，避免每次构造 std::string
+const char* fieldName(char (&buffer)[128], const char* name, const char* field) {
+    std::snprintf(buffer, sizeof(buffer), "%s.%s", name, field);
+    return buffer;
+}
+
+} // namespace
+
 void Light::setUniform(unsigned int shaderProgram, const std::string& name) const {
+    TRACE_ZONE("Light::setUniform");
+    char buffer[128];
+    const char* base = name.c_str();
+
     // 设置光源类型
     glUseProgram(shaderProgram);
     
     // 设置光源属性
-    glUniform3fv(glGetUniformLocation(shaderProgram, (name + ".position").c_str()), 1, &position[0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, (name + ".direction").c_str()), 1, &direction[0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, (name + ".ambient").c_str()), 1, &ambient[0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, (name + ".diffuse").c_str()), 1, &diffuse[0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, (name + ".specular").c_str()), 1, &specular[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "position")), 1, &position[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "direction")), 1, &direction[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "ambient")), 1, &ambient[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "diffuse")), 1, &diffuse[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "specular")), 1, &specular[0]);
     
     // 设置衰减参数
-    glUniform1f(glGetUniformLocation(shaderProgram, (name + ".constant").c_str()), constant);
-    glUniform1f(glGetUniformLocation(shaderProgram, (name + ".linear").c_str()), linear);
-    glUniform1f(glGetUniformLocation(shaderProgram, (name + ".quadratic").c_str()), quadratic);
+    glUniform1f(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "constant")), constant);
+    glUniform1f(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "linear")), linear);
+    glUniform1f(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "quadratic")), quadratic);
     
     // 设置聚光灯参数
-    glUniform1f(glGetUniformLocation(shaderProgram, (name + ".cutOff").c_str()), cutOff);
-    glUniform1f(glGetUniformLocation(shaderProgram, (name + ".outerCutOff").c_str()), outerCutOff);
+    glUniform1f(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "cutOff")), cutOff);
+    glUniform1f(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "outerCutOff")), outerCutOff);
     
     // 传递光源类型（作为整数）
-    glUniform1i(glGetUniformLocation(shaderProgram, (name + ".type").c_str()), static_cast<int>(type));
+    glUniform1i(glGetUniformLocation(shaderProgram, fieldName(buffer, base, "type")), static_cast<int>(type));
+}
+
+void Light::setUniform(const Shader& shader, const LightUniforms& handles) const {
+    TRACE_ZONE("Light::setUniform");
+    shader.setVec3(handles.position, position);
+    shader.setVec3(handles.direction, direction);
+    shader.setVec3(handles.ambient, ambient);
+    shader.setVec3(handles.diffuse, diffuse);
+    shader.setVec3(handles.specular, specular);
+
+    shader.setFloat(handles.constant, constant);
+    shader.setFloat(handles.linear, linear);
+    shader.setFloat(handles.quadratic, quadratic);
+
+    shader.setFloat(handles.cutOff, cutOff);
+    shader.setFloat(handles.outerCutOff, outerCutOff);
+
+    shader.setInt(handles.type, static_cast<int>(type));
+}
+
+LightUniforms Light::resolveUniforms(const Shader& shader, const char* name) {
+    char buffer[128];
+    LightUniforms handles;
+    handles.position    = shader.getUniform(fieldName(buffer, name, "position"));
+    handles.direction   = shader.getUniform(fieldName(buffer, name, "direction"));
+    handles.ambient     = shader.getUniform(fieldName(buffer, name, "ambient"));
+    handles.diffuse     = shader.getUniform(fieldName(buffer, name, "diffuse"));
+    handles.specular    = shader.getUniform(fieldName(buffer, name, "specular"));
+    handles.constant    = shader.getUniform(fieldName(buffer, name, "constant"));
+    handles.linear      = shader.getUniform(fieldName(buffer, name, "linear"));
+    handles.quadratic   = shader.getUniform(fieldName(buffer, name, "quadratic"));
+    handles.cutOff      = shader.getUniform(fieldName(buffer, name, "cutOff"));
+    handles.outerCutOff = shader.getUniform(fieldName(buffer, name, "outerCutOff"));
+    handles.type        = shader.getUniform(fieldName(buffer, name, "type"));
+    return handles;
+}
+
+GPULight Light::toGPU() const {
+    GPULight gpu;
+    gpu.positionType       = glm::vec4(position, static_cast<float>(type));
+    gpu.directionCutOff    = glm::vec4(direction, cutOff);
+    gpu.ambientOuterCutOff = glm::vec4(ambient, outerCutOff);
+    gpu.diffuse            = glm::vec4(diffuse, 0.0f);
+    gpu.specular           = glm::vec4(specular, 0.0f);
+    gpu.attenuation        = glm::vec4(constant, linear, quadratic, getRange());
+    return gpu;
+}
+
+float Light::getRange() const {
+    if (type == DIRECTIONAL_LIGHT) {
+        return std::numeric_limits<float>::infinity();
+    }
+    float intensity = glm::max(glm::max(ambient.x, ambient.y), ambient.z);
+    intensity = glm::max(intensity, glm::max(glm::max(diffuse.x, diffuse.y), diffuse.z));
+    intensity = glm::max(intensity, glm::max(glm::max(specular.x, specular.y), specular.z));
+    return computeLightRange(constant, linear, quadratic, intensity);
 }
 
 void Light::setTypePoint() {
@@ -0,0 +1,29 @@
+#include <light/light_buffer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+LightBuffer::LightBuffer() : m_ubo(sizeof(LightBlock), LIGHT_DATA_BINDING) {
+    m_block.lightCount = glm::ivec4(0);
+}
+
+void LightBuffer::upload(const std::vector<Light*>& lights) {
+    int count = std::min((int)lights.size(), MAX_LIGHTS);
+    if ((int)lights.size() > MAX_LIGHTS) {
+        static bool warned = false;
+        if (!warned) {
+            std::cerr << "LightBuffer: " << lights.size() << " lights exceed MAX_LIGHTS (" << MAX_LIGHTS
+                      << "), extra lights are ignored." << std::endl;
+            warned = true;
+        }
+    }
+
+    m_block.lightCount = glm::ivec4(count, 0, 0, 0);
+    for (int i = 0; i < count; ++i) {
+        m_block.lights[i] = lights[i]->toGPU();
+    }
+
+    // 只上传有效部分
+    GLsizeiptr size = offsetof(LightBlock, lights) + count * sizeof(GPULight);
+    m_ubo.update(&m_block, size);
+}
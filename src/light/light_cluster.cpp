@@ -0,0 +1,172 @@
+#include <light/light_cluster.hpp>
+#include <basic/trace.hpp>
+#include <basic/worker_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+float computeLightRange(float constant, float linear, float quadratic, float intensity, float threshold) {
+    // 需满足 constant + linear*d + quadratic*d^2 = intensity / threshold
+    float target = intensity / threshold;
+    if (constant >= target) return 0.0f;
+
+    if (quadratic > 0.0f) {
+        float discriminant = linear * linear - 4.0f * quadratic * (constant - target);
+        return (-linear + std::sqrt(discriminant)) / (2.0f * quadratic);
+    }
+    if (linear > 0.0f) {
+        return (target - constant) / linear;
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+LightClusterer::LightClusterer(int tilesX, int tilesY, int slicesZ, WorkerPool* pool)
+    : m_tilesX(tilesX), m_tilesY(tilesY), m_slicesZ(slicesZ), m_pool(pool ? pool : &WorkerPool::shared()) {
+    m_ranges.assign(getClusterCount() * 2, 0);
+}
+
+void LightClusterer::setProjection(float fovY, float aspect, float nearPlane, float farPlane) {
+    if (fovY == m_fovY && aspect == m_aspect && nearPlane == m_near && farPlane == m_far) return;
+    m_fovY = fovY;
+    m_aspect = aspect;
+    m_near = nearPlane;
+    m_far = farPlane;
+
+    // 深度按指数划分：depth(z) = near * (far/near)^(z/slices)
+    float logRatio = std::log(farPlane / nearPlane);
+    m_sliceScale = (float)m_slicesZ / logRatio;
+    m_sliceBias = -(float)m_slicesZ * std::log(nearPlane) / logRatio;
+
+    int count = getClusterCount();
+    m_minX.resize(count); m_minY.resize(count); m_minZ.resize(count);
+    m_maxX.resize(count); m_maxY.resize(count); m_maxZ.resize(count);
+
+    float tanY = std::tan(fovY * 0.5f);
+    float tanX = tanY * aspect;
+
+    for (int z = 0; z < m_slicesZ; ++z) {
+        float depthNear = nearPlane * std::pow(farPlane / nearPlane, (float)z / m_slicesZ);
+        float depthFar = nearPlane * std::pow(farPlane / nearPlane, (float)(z + 1) / m_slicesZ);
+
+        for (int y = 0; y < m_tilesY; ++y) {
+            // 瓦片在 NDC 中的范围 [-1, 1]
+            float ndcY0 = -1.0f + 2.0f * y / m_tilesY;
+            float ndcY1 = -1.0f + 2.0f * (y + 1) / m_tilesY;
+
+            for (int x = 0; x < m_tilesX; ++x) {
+                float ndcX0 = -1.0f + 2.0f * x / m_tilesX;
+                float ndcX1 = -1.0f + 2.0f * (x + 1) / m_tilesX;
+
+                // 瓦片四个角在近、远两个深度上的视空间坐标取包围盒
+                float xs[4] = { ndcX0 * tanX * depthNear, ndcX1 * tanX * depthNear,
+                                ndcX0 * tanX * depthFar,  ndcX1 * tanX * depthFar };
+                float ys[4] = { ndcY0 * tanY * depthNear, ndcY1 * tanY * depthNear,
+                                ndcY0 * tanY * depthFar,  ndcY1 * tanY * depthFar };
+
+                int index = x + m_tilesX * (y + m_tilesY * z);
+                m_minX[index] = *std::min_element(xs, xs + 4);
+                m_maxX[index] = *std::max_element(xs, xs + 4);
+                m_minY[index] = *std::min_element(ys, ys + 4);
+                m_maxY[index] = *std::max_element(ys, ys + 4);
+                // 视空间朝向 -Z
+                m_minZ[index] = -depthFar;
+                m_maxZ[index] = -depthNear;
+            }
+        }
+    }
+}
+
+void LightClusterer::assign(const std::vector<glm::vec4>& viewSpaceLights, unsigned threadCount) {
+    // 转为 SoA，便于向量化
+    size_t lightCount = viewSpaceLights.size();
+    m_lightX.resize(lightCount); m_lightY.resize(lightCount);
+    m_lightZ.resize(lightCount); m_lightR2.resize(lightCount);
+    for (size_t i = 0; i < lightCount; ++i) {
+        m_lightX[i] = viewSpaceLights[i].x;
+        m_lightY[i] = viewSpaceLights[i].y;
+        m_lightZ[i] = viewSpaceLights[i].z;
+        m_lightR2[i] = viewSpaceLights[i].w * viewSpaceLights[i].w;
+    }
+
+    if (threadCount == 0) threadCount = m_pool->getThreadCount();
+    threadCount = std::min(threadCount, (unsigned)m_slicesZ);
+    m_scratch.resize(threadCount);
+
+    // 按深度切片划分；每份写入自己的索引表与各自簇的计数
+    auto sliceBegin = [&](unsigned t) { return (int)((long long)m_slicesZ * t / threadCount); };
+    m_pool->parallelFor(threadCount, [&](unsigned t) {
+        assignSlices(sliceBegin(t), sliceBegin(t + 1), m_scratch[t]);
+    });
+
+    // 合并：按切片顺序排列，簇的偏移加上前面各份的索引总数
+    m_indices.clear();
+    for (unsigned t = 0; t < threadCount; ++t) {
+        uint32_t base = (uint32_t)m_indices.size();
+        int firstCluster = sliceBegin(t) * m_tilesX * m_tilesY;
+        int lastCluster = sliceBegin(t + 1) * m_tilesX * m_tilesY;
+        for (int c = firstCluster; c < lastCluster; ++c) {
+            m_ranges[c * 2] += base;
+        }
+        const std::vector<uint32_t>& indices = m_scratch[t].indices;
+        m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+    }
+}
+
+void LightClusterer::assignSlices(int sliceBegin, int sliceEnd, SliceScratch& scratch) {
+    TRACE_ZONE("LightClusterer::assignSlices");
+    std::vector<uint32_t>& indices = scratch.indices;
+    std::vector<uint32_t>& candidates = scratch.candidates;
+    indices.clear();
+
+    // 只在光源数增长时重新分配
+    size_t lightCount = m_lightX.size();
+    if (scratch.cx.size() < lightCount) {
+        scratch.cx.resize(lightCount); scratch.cy.resize(lightCount);
+        scratch.cz.resize(lightCount); scratch.cr2.resize(lightCount);
+        scratch.hit.resize(lightCount);
+    }
+    float* cx = scratch.cx.data();
+    float* cy = scratch.cy.data();
+    float* cz = scratch.cz.data();
+    float* cr2 = scratch.cr2.data();
+    uint8_t* hit = scratch.hit.data();
+
+    const int tilesPerSlice = m_tilesX * m_tilesY;
+    for (int z = sliceBegin; z < sliceEnd; ++z) {
+        // 先按切片深度范围粗筛光源
+        int first = z * tilesPerSlice;
+        float sliceMinZ = m_minZ[first], sliceMaxZ = m_maxZ[first];
+        candidates.clear();
+        for (size_t i = 0; i < lightCount; ++i) {
+            float dz = std::max(std::max(sliceMinZ - m_lightZ[i], m_lightZ[i] - sliceMaxZ), 0.0f);
+            if (dz * dz <= m_lightR2[i]) candidates.push_back((uint32_t)i);
+        }
+
+        // 候选光源紧凑排列
+        size_t n = candidates.size();
+        for (size_t k = 0; k < n; ++k) {
+            uint32_t i = candidates[k];
+            cx[k] = m_lightX[i]; cy[k] = m_lightY[i]; cz[k] = m_lightZ[i]; cr2[k] = m_lightR2[i];
+        }
+
+        for (int c = first; c < first + tilesPerSlice; ++c) {
+            const float minX = m_minX[c], minY = m_minY[c], minZ = m_minZ[c];
+            const float maxX = m_maxX[c], maxY = m_maxY[c], maxZ = m_maxZ[c];
+
+            // 无分支的球-盒测试，可被自动向量化
+            for (size_t k = 0; k < n; ++k) {
+                float dx = std::max(std::max(minX - cx[k], cx[k] - maxX), 0.0f);
+                float dy = std::max(std::max(minY - cy[k], cy[k] - maxY), 0.0f);
+                float dz = std::max(std::max(minZ - cz[k], cz[k] - maxZ), 0.0f);
+                hit[k] = (dx * dx + dy * dy + dz * dz <= cr2[k]) ? 1 : 0;
+            }
+
+            // 偏移先记录为线程内偏移，合并时再加上基址
+            m_ranges[c * 2] = (uint32_t)indices.size();
+            for (size_t k = 0; k < n; ++k) {
+                if (hit[k]) indices.push_back(candidates[k]);
+            }
+            m_ranges[c * 2 + 1] = (uint32_t)indices.size() - m_ranges[c * 2];
+        }
+    }
+}
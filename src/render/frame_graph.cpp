@@ -0,0 +1,506 @@
+#include <render/frame_graph.hpp>
+#include <render/profiler.hpp>
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+bool hasStencil(GLenum internalFormat) {
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+/**
+ * @brief 创建渲染目标纹理（最近邻采样、边缘截取：通道之间按像素一一对应读取）
+ */
+GLuint createRenderTarget(const FrameTextureDesc& desc) {
+    // 不上传数据，format/type 只需与内部格式兼容
+    GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+    if (hasStencil(desc.internalFormat)) {
+        format = GL_DEPTH_STENCIL;
+        type = desc.internalFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+    } else if (desc.isDepth()) {
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+} // namespace
+
+// FrameTextureDesc implementation
+bool FrameTextureDesc::isDepth() const {
+    switch (internalFormat) {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t FrameTextureDesc::getBytes() const {
+    size_t bytesPerPixel;
+    switch (internalFormat) {
+        case GL_R8:
+            bytesPerPixel = 1;
+            break;
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            bytesPerPixel = 2;
+            break;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:
+            bytesPerPixel = 8;
+            break;
+        case GL_RGBA32F:
+            bytesPerPixel = 16;
+            break;
+        default:
+            bytesPerPixel = 4;  // RGBA8、RGB10_A2、R11F_G11F_B10F、DEPTH24（按 32 位存放）等
+            break;
+    }
+    return (size_t)width * height * bytesPerPixel;
+}
+
+// PassBuilder implementation
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::read(Resource resource) {
+    PassNode& pass = m_graph.m_passes[m_pass];
+    if (std::find(pass.reads.begin(), pass.reads.end(), resource) == pass.reads.end()) {
+        pass.reads.push_back(resource);
+        m_graph.m_resources.at(resource).readers.push_back(m_pass);
+    }
+    return *this;
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::write(Resource resource, LoadOp load) {
+    PassNode& pass = m_graph.m_passes[m_pass];
+    for (const auto& write : pass.writes) {
+        if (write.first == resource) return *this;
+    }
+    pass.writes.emplace_back(resource, load);
+    m_graph.m_resources.at(resource).writers.push_back(m_pass);
+    return *this;
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::setSideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+    return *this;
+}
+
+// FrameGraph implementation
+FrameGraph::FrameGraph() {
+    glGenVertexArrays(1, &m_emptyVAO);
+}
+
+FrameGraph::~FrameGraph() {
+    for (const auto& entry : m_framebuffers) glDeleteFramebuffers(1, &entry.second);
+    for (const auto& texture : m_textures) glDeleteTextures(1, &texture.id);
+    glDeleteVertexArrays(1, &m_emptyVAO);
+}
+
+void FrameGraph::reset() {
+    m_resources.clear();
+    m_passes.clear();
+    m_order.clear();
+    m_stats = Stats();
+    m_compiled = false;
+}
+
+FrameGraph::Resource FrameGraph::createTexture(const std::string& name, const FrameTextureDesc& desc) {
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    m_resources.push_back(std::move(node));
+    return (Resource)(m_resources.size() - 1);
+}
+
+FrameGraph::Resource FrameGraph::importFramebuffer(const std::string& name, GLuint framebuffer, int width,
+                                                   int height, const glm::vec4& clearColor) {
+    ResourceNode node;
+    node.name = name;
+    node.desc = FrameTextureDesc{ width, height, GL_RGBA8 };
+    node.imported = true;
+    node.framebuffer = framebuffer;
+    node.clearColor = clearColor;
+    m_resources.push_back(std::move(node));
+    return (Resource)(m_resources.size() - 1);
+}
+
+FrameGraph::PassBuilder FrameGraph::addPass(const std::string& name, ExecuteFn execute) {
+    PassNode pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+    return PassBuilder(*this, m_passes.size() - 1);
+}
+
+void FrameGraph::compile() {
+    m_stats = Stats();
+    for (const auto& pass : m_passes) {
+        bool writesImported = false, writesTexture = false;
+        for (const auto& write : pass.writes) {
+            (m_resources[write.first].imported ? writesImported : writesTexture) = true;
+        }
+        if (writesImported && writesTexture) {
+            throw std::logic_error("FrameGraph: pass '" + pass.name + "' writes both an imported framebuffer and textures");
+        }
+    }
+
+    cullPasses();
+    sortPasses();
+    assignPhysicalTextures();
+    m_compiled = true;
+}
+
+void FrameGraph::cullPasses() {
+    // 通道的引用计数为其写入的资源数，资源的引用计数为读取它的通道数；
+    // 从无人读取的瞬态资源出发，沿写入者反向传播，写入结果全部无人使用的通道被剔除
+    std::vector<size_t> passRefs(m_passes.size());
+    std::vector<size_t> resourceRefs(m_resources.size());
+    std::vector<bool> pinned(m_passes.size(), false);
+
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        PassNode& pass = m_passes[i];
+        pass.culled = false;
+        passRefs[i] = pass.writes.size();
+        pinned[i] = pass.sideEffect;
+        for (const auto& write : pass.writes) {
+            if (m_resources[write.first].imported) pinned[i] = true;
+        }
+    }
+    for (size_t r = 0; r < m_resources.size(); ++r) {
+        resourceRefs[r] = m_resources[r].readers.size();
+    }
+
+    std::vector<size_t> unreferenced;
+    auto cullPass = [&](size_t index) {
+        m_passes[index].culled = true;
+        m_stats.culledPasses++;
+        for (Resource read : m_passes[index].reads) {
+            if (--resourceRefs[read] == 0 && !m_resources[read].imported) unreferenced.push_back(read);
+        }
+    };
+
+    // 先收集初始无人读取的资源，再剔除不写任何资源的通道（它们读的资源计数归零时才入栈，避免重复）
+    for (size_t r = 0; r < m_resources.size(); ++r) {
+        if (resourceRefs[r] == 0 && !m_resources[r].imported) unreferenced.push_back(r);
+    }
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (passRefs[i] == 0 && !pinned[i]) cullPass(i);
+    }
+
+    while (!unreferenced.empty()) {
+        size_t resource = unreferenced.back();
+        unreferenced.pop_back();
+        for (size_t writer : m_resources[resource].writers) {
+            if (pinned[writer] || m_passes[writer].culled) continue;
+            if (--passRefs[writer] == 0) cullPass(writer);
+        }
+    }
+}
+
+void FrameGraph::sortPasses() {
+    // 依赖：同一资源的写入者按声明顺序先后执行；读取者在所有其他写入者之后执行
+    // （读写同一资源的通道只依赖在它之前声明的写入者）
+    std::vector<std::vector<size_t>> successors(m_passes.size());
+    std::vector<size_t> inDegree(m_passes.size(), 0);
+    auto addEdge = [&](size_t from, size_t to) {
+        successors[from].push_back(to);
+        inDegree[to]++;
+    };
+
+    for (const auto& resource : m_resources) {
+        std::vector<size_t> writers;
+        for (size_t writer : resource.writers) {
+            if (!m_passes[writer].culled) writers.push_back(writer);
+        }
+        for (size_t i = 1; i < writers.size(); ++i) addEdge(writers[i - 1], writers[i]);
+
+        for (size_t reader : resource.readers) {
+            if (m_passes[reader].culled) continue;
+            bool readWrite = std::find(writers.begin(), writers.end(), reader) != writers.end();
+            for (size_t writer : writers) {
+                if (writer == reader || (readWrite && writer > reader)) continue;
+                addEdge(writer, reader);
+            }
+        }
+    }
+
+    // Kahn 算法，可执行的通道中先执行声明较早的
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+    size_t liveCount = 0;
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (m_passes[i].culled) continue;
+        liveCount++;
+        if (inDegree[i] == 0) ready.push(i);
+    }
+
+    m_order.clear();
+    while (!ready.empty()) {
+        size_t pass = ready.top();
+        ready.pop();
+        m_order.push_back(pass);
+        for (size_t next : successors[pass]) {
+            if (--inDegree[next] == 0) ready.push(next);
+        }
+    }
+    if (m_order.size() != liveCount) {
+        throw std::logic_error("FrameGraph: dependency cycle between passes");
+    }
+    m_stats.passCount = m_passes.size();
+}
+
+void FrameGraph::assignPhysicalTextures() {
+    // 生命周期：资源在执行顺序中第一次与最后一次被使用的位置
+    for (auto& resource : m_resources) {
+        resource.firstUse = resource.lastUse = -1;
+        resource.firstWriter = SIZE_MAX;
+        resource.physical = -1;
+    }
+    for (int position = 0; position < (int)m_order.size(); ++position) {
+        size_t index = m_order[position];
+        const PassNode& pass = m_passes[index];
+        auto use = [&](Resource r) {
+            ResourceNode& resource = m_resources[r];
+            if (resource.firstUse < 0) resource.firstUse = position;
+            resource.lastUse = position;
+        };
+        for (Resource read : pass.reads) use(read);
+        for (const auto& write : pass.writes) {
+            use(write.first);
+            if (m_resources[write.first].firstWriter == SIZE_MAX) m_resources[write.first].firstWriter = index;
+        }
+    }
+
+    // 按首次使用的顺序分配：复用描述相同、且上一个使用者已经结束的物理纹理
+    std::vector<size_t> transients;
+    for (size_t r = 0; r < m_resources.size(); ++r) {
+        const ResourceNode& resource = m_resources[r];
+        if (resource.imported || resource.firstUse < 0) continue;
+        if (resource.firstWriter == SIZE_MAX) {
+            std::cerr << "WARNING::FRAMEGRAPH::RESOURCE_READ_BEFORE_WRITE: " << resource.name << std::endl;
+        }
+        transients.push_back(r);
+    }
+    std::stable_sort(transients.begin(), transients.end(), [this](size_t a, size_t b) {
+        return m_resources[a].firstUse < m_resources[b].firstUse;
+    });
+
+    for (auto& texture : m_textures) {
+        texture.busyUntil = -1;
+        texture.used = false;
+    }
+    for (size_t r : transients) {
+        ResourceNode& resource = m_resources[r];
+        int physical = -1;
+        for (size_t t = 0; t < m_textures.size(); ++t) {
+            if (m_textures[t].desc == resource.desc && m_textures[t].busyUntil < resource.firstUse) {
+                physical = (int)t;
+                break;
+            }
+        }
+        if (physical < 0) {
+            PhysicalTexture texture;
+            texture.id = createRenderTarget(resource.desc);
+            texture.desc = resource.desc;
+            m_textures.push_back(texture);
+            physical = (int)m_textures.size() - 1;
+        }
+        m_textures[physical].busyUntil = resource.lastUse;
+        m_textures[physical].used = true;
+        resource.physical = physical;
+
+        m_stats.transientTextures++;
+        m_stats.transientBytes += resource.desc.getBytes();
+    }
+
+    releaseUnusedTextures();
+
+    for (const auto& texture : m_textures) {
+        m_stats.physicalTextures++;
+        m_stats.physicalBytes += texture.desc.getBytes();
+    }
+}
+
+void FrameGraph::releaseUnusedTextures() {
+    // 本帧没用到的物理纹理（例如窗口尺寸改变后的旧纹理）连同引用它的 FBO 一起释放
+    std::vector<int> remap(m_textures.size(), -1);
+    std::vector<PhysicalTexture> kept;
+    for (size_t t = 0; t < m_textures.size(); ++t) {
+        if (m_textures[t].used) {
+            remap[t] = (int)kept.size();
+            kept.push_back(m_textures[t]);
+            continue;
+        }
+
+        GLuint id = m_textures[t].id;
+        for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();) {
+            if (std::find(it->first.begin(), it->first.end(), id) != it->first.end()) {
+                glDeleteFramebuffers(1, &it->second);
+                it = m_framebuffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        glDeleteTextures(1, &id);
+    }
+    if (kept.size() == m_textures.size()) return;
+
+    m_textures = std::move(kept);
+    for (auto& resource : m_resources) {
+        if (resource.physical >= 0) resource.physical = remap[resource.physical];
+    }
+}
+
+GLuint FrameGraph::getFramebuffer(const std::vector<GLuint>& colors, GLuint depth, bool depthStencil) {
+    std::vector<GLuint> key = colors;
+    key.push_back(depth);
+    auto it = m_framebuffers.find(key);
+    if (it != m_framebuffers.end()) return it->second;
+
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < colors.size(); ++i) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, GL_TEXTURE_2D, colors[i], 0);
+        drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
+    }
+    if (depth) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, depthStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT,
+                               GL_TEXTURE_2D, depth, 0);
+    }
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    } else {
+        glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::FRAMEGRAPH::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    }
+
+    m_framebuffers[key] = fbo;
+    return fbo;
+}
+
+void FrameGraph::execute(Profiler* profiler) {
+    if (!m_compiled) compile();
+
+    for (size_t index : m_order) {
+        PassNode& pass = m_passes[index];
+        Profiler::Scope zone(profiler, pass.name.c_str());
+
+        // 收集附件
+        std::vector<GLuint> colors;
+        std::vector<GLint> colorClears;     // 需要清除的颜色附件序号
+        GLuint depth = 0;
+        bool depthStencil = false, depthClear = false;
+        const ResourceNode* backbuffer = nullptr;
+        bool backbufferClear = false;
+        const FrameTextureDesc* viewport = nullptr;
+
+        for (const auto& write : pass.writes) {
+            const ResourceNode& resource = m_resources[write.first];
+            bool clear = resource.firstWriter == index && write.second == LoadOp::CLEAR;
+            if (!viewport) viewport = &resource.desc;
+
+            if (resource.imported) {
+                backbuffer = &resource;
+                backbufferClear = backbufferClear || clear;
+            } else if (resource.desc.isDepth()) {
+                depth = m_textures[resource.physical].id;
+                depthStencil = hasStencil(resource.desc.internalFormat);
+                depthClear = clear;
+            } else {
+                if (clear) colorClears.push_back((GLint)colors.size());
+                colors.push_back(m_textures[resource.physical].id);
+            }
+        }
+
+        if (backbuffer) {
+            glBindFramebuffer(GL_FRAMEBUFFER, backbuffer->framebuffer);
+        } else if (!colors.empty() || depth) {
+            glBindFramebuffer(GL_FRAMEBUFFER, getFramebuffer(colors, depth, depthStencil));
+        }
+        if (viewport) glViewport(0, 0, viewport->width, viewport->height);
+
+        // 只在资源本帧第一次被写入时清除
+        if (backbufferClear) {
+            const glm::vec4& c = backbuffer->clearColor;
+            glClearColor(c.r, c.g, c.b, c.a);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+        for (GLint drawBuffer : colorClears) {
+            const GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            glClearBufferfv(GL_COLOR, drawBuffer, zero);
+        }
+        if (depthClear) {
+            if (depthStencil) {
+                glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+            } else {
+                const GLfloat one = 1.0f;
+                glClearBufferfv(GL_DEPTH, 0, &one);
+            }
+        }
+
+        pass.execute(*this);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint FrameGraph::getTexture(Resource resource) const {
+    const ResourceNode& node = m_resources.at(resource);
+    return node.physical >= 0 ? m_textures[node.physical].id : 0;
+}
+
+void FrameGraph::bindTexture(Resource resource, GLuint unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, getTexture(resource));
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void FrameGraph::drawFullscreenTriangle() const {
+    glBindVertexArray(m_emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
+
+void FrameGraph::print(std::ostream& out) const {
+    out << "Frame graph: " << m_order.size() << " passes";
+    for (size_t index : m_order) out << " -> " << m_passes[index].name;
+    out << std::endl;
+
+    for (const auto& pass : m_passes) {
+        if (pass.culled) out << "  culled: " << pass.name << std::endl;
+    }
+    for (const auto& resource : m_resources) {
+        if (resource.imported || resource.physical < 0) continue;
+        out << "  " << resource.name << " [" << resource.firstUse << ", " << resource.lastUse << "] -> texture #"
+            << resource.physical << std::endl;
+    }
+    out << "  transient textures " << m_stats.transientTextures << " (" << m_stats.transientBytes / 1024
+        << " KB) on " << m_stats.physicalTextures << " physical (" << m_stats.physicalBytes / 1024 << " KB)"
+        << std::endl;
+}
@@ -0,0 +1,23 @@
+#include <render/gbuffer.hpp>
+
+GBuffer GBuffer::declare(FrameGraph& graph, int width, int height) {
+    GBuffer gbuffer;
+    gbuffer.albedo = graph.createTexture("gAlbedoSpecular", FrameTextureDesc{ width, height, GL_RGBA8 });
+    gbuffer.normal = graph.createTexture("gNormalShininess", FrameTextureDesc{ width, height, GL_RGB10_A2 });
+    gbuffer.depth = graph.createTexture("gDepth", FrameTextureDesc{ width, height, GL_DEPTH_COMPONENT24 });
+    return gbuffer;
+}
+
+void GBuffer::declareWrites(FrameGraph::PassBuilder& pass) const {
+    pass.write(albedo).write(normal).write(depth);
+}
+
+void GBuffer::declareReads(FrameGraph::PassBuilder& pass) const {
+    pass.read(albedo).read(normal).read(depth);
+}
+
+void GBuffer::bindTextures(const FrameGraph& graph) const {
+    graph.bindTexture(albedo, GBUFFER_ALBEDO_UNIT);
+    graph.bindTexture(normal, GBUFFER_NORMAL_UNIT);
+    graph.bindTexture(depth, GBUFFER_DEPTH_UNIT);
+}
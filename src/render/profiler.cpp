@@ -0,0 +1,127 @@
+#include <render/profiler.hpp>
+
+Profiler::Profiler() = default;
+
+Profiler::~Profiler() {
+    if (m_gpuActive) glEndQuery(GL_TIME_ELAPSED);
+    for (FrameSlot& slot : m_slots) {
+        if (!slot.queries.empty()) glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+    }
+}
+
+void Profiler::beginFrame() {
+    if (!m_enabled || m_inFrame) return;
+
+    FrameSlot& slot = m_slots[m_frame % FRAME_LATENCY];
+    // 这一组查询要被复用了；结果仍未完成就放弃这一帧（阻塞模式下等待 GPU）
+    if (slot.pending && !resolve(slot, m_blocking)) {
+        slot.pending = false;
+        m_dropped++;
+    }
+
+    slot.zoneCount = 0;
+    slot.queryCount = 0;
+    slot.start = Clock::now();
+    m_stack.clear();
+    m_inFrame = true;
+}
+
+void Profiler::endFrame() {
+    if (!m_inFrame) return;
+    while (!m_stack.empty()) endZone();
+
+    FrameSlot& slot = m_slots[m_frame % FRAME_LATENCY];
+    slot.cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - slot.start).count();
+    slot.frame = m_frame;
+    slot.pending = true;
+    m_inFrame = false;
+    m_frame++;
+
+    // 从最早的一帧开始取回，保持曲线按帧顺序；遇到未完成的帧即停止
+    for (int age = FRAME_LATENCY; age >= 1; --age) {
+        if (m_frame < (uint64_t)age) continue;
+        FrameSlot& older = m_slots[(m_frame - age) % FRAME_LATENCY];
+        if (older.pending && !resolve(older)) break;
+    }
+}
+
+void Profiler::flush() {
+    for (int age = FRAME_LATENCY; age >= 1; --age) {
+        if (m_frame < (uint64_t)age) continue;
+        FrameSlot& older = m_slots[(m_frame - age) % FRAME_LATENCY];
+        if (older.pending) resolve(older, true);
+    }
+}
+
+void Profiler::beginZone(const char* name, bool gpu) {
+    if (!m_inFrame) return;
+
+    FrameSlot& slot = m_slots[m_frame % FRAME_LATENCY];
+    if (slot.zoneCount == slot.zones.size()) slot.zones.emplace_back();
+    ZoneRecord& zone = slot.zones[slot.zoneCount++];
+    zone.name.assign(name);
+    zone.depth = (int)m_stack.size();
+    zone.query = -1;
+
+    if (gpu && !m_gpuActive) {
+        if (slot.queryCount == slot.queries.size()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            slot.queries.push_back(query);
+        }
+        zone.query = (int)slot.queryCount++;
+        glBeginQuery(GL_TIME_ELAPSED, slot.queries[zone.query]);
+        m_gpuActive = true;
+    }
+
+    m_stack.push_back(slot.zoneCount - 1);
+    zone.start = Clock::now();
+}
+
+void Profiler::endZone() {
+    if (!m_inFrame || m_stack.empty()) return;
+
+    FrameSlot& slot = m_slots[m_frame % FRAME_LATENCY];
+    ZoneRecord& zone = slot.zones[m_stack.back()];
+    m_stack.pop_back();
+    zone.cpuMs = std::chrono::duration<double, std::milli>(Clock::now() - zone.start).count();
+    if (zone.query >= 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_gpuActive = false;
+    }
+}
+
+bool Profiler::resolve(FrameSlot& slot, bool wait) {
+    // 查询按提交顺序完成，最后一个可用则全部可用；等待时由 GL_QUERY_RESULT 阻塞到结果就绪
+    if (!wait && slot.queryCount > 0) {
+        GLint available = 0;
+        glGetQueryObjectiv(slot.queries[slot.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    m_latest.resize(slot.zoneCount);
+    m_latestGpuMs = 0.0;
+    for (size_t i = 0; i < slot.zoneCount; ++i) {
+        const ZoneRecord& zone = slot.zones[i];
+        ZoneResult& result = m_latest[i];
+        result.name.assign(zone.name);
+        result.depth = zone.depth;
+        result.cpuMs = zone.cpuMs;
+        result.gpuMs = -1.0;
+        if (zone.query >= 0) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(slot.queries[zone.query], GL_QUERY_RESULT, &nanoseconds);
+            result.gpuMs = nanoseconds / 1.0e6;
+            m_latestGpuMs += result.gpuMs;
+        }
+    }
+    m_latestCpuMs = slot.cpuMs;
+
+    m_cpuHistory[m_historyOffset] = (float)m_latestCpuMs;
+    m_gpuHistory[m_historyOffset] = (float)m_latestGpuMs;
+    m_historyOffset = (m_historyOffset + 1) % HISTORY_SIZE;
+
+    slot.pending = false;
+    if (m_frameCallback) m_frameCallback(slot.frame, m_latestCpuMs, m_latestGpuMs);
+    return true;
+}
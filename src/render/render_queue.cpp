@@ -0,0 +1,98 @@
+#include <render/render_queue.hpp>
+#include <basic/trace.hpp>
+#include <algorithm>
+#include <cstring>
+
+void RenderQueue::clear() {
+    m_packets.clear();
+    m_order.clear();
+    m_programIndices.clear();
+    m_vaoIndices.clear();
+}
+
+void RenderQueue::push(Shader* shader, const ColoredShape& shape, const glm::mat4& view, uint16_t material) {
+    DrawPacket packet;
+    packet.shader = shader;
+    packet.cmd = shape.getDrawCommand();
+    packet.model = shape.getModelMatrix();
+    packet.normal = shape.getNormalMatrix();
+    packet.color = shape.getColor();
+
+    // 视空间中摄像机朝向 -Z，深度取物体原点的 -z
+    float depth = -(view * packet.model[3]).z;
+    uint32_t programIndex = denseIndex(m_programIndices, shader->ID, 0xFFu);
+    uint32_t vaoIndex = denseIndex(m_vaoIndices, packet.cmd.vao, 0xFFFFu);
+    packet.key = makeSortKey(programIndex, vaoIndex, material, depth);
+
+    m_order.emplace_back(packet.key, (uint32_t)m_packets.size());
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::submit(RenderStats& stats) {
+    TRACE_ZONE("RenderQueue::submit");
+    std::sort(m_order.begin(), m_order.end());
+
+    GLuint currentProgram = 0;
+    GLuint currentVAO = 0;
+    UniformHandle modelHandle, normalHandle;
+    bool hasColor = false;
+    glm::vec3 currentColor(0.0f);
+    for (const auto& entry : m_order) {
+        const DrawPacket& packet = m_packets[entry.second];
+
+        if (packet.shader->ID != currentProgram) {
+            packet.shader->use();
+            currentProgram = packet.shader->ID;
+            modelHandle = packet.shader->getUniform("model");
+            normalHandle = packet.shader->getUniform("normalMatrix");
+            stats.programBinds++;
+        }
+        if (packet.cmd.vao != currentVAO) {
+            glBindVertexArray(packet.cmd.vao);
+            currentVAO = packet.cmd.vao;
+            stats.vaoBinds++;
+        }
+
+        packet.shader->setMat4(modelHandle, packet.model);
+        packet.shader->setMat3(normalHandle, packet.normal);
+        stats.modelUploads++;
+
+        // 颜色不在共享网格的顶点流中，作为通用顶点属性设置
+        if (!hasColor || packet.color != currentColor) {
+            glVertexAttrib3fv(2, &packet.color[0]);
+            currentColor = packet.color;
+            hasColor = true;
+        }
+
+        packet.cmd.issue();
+        stats.drawCalls++;
+        stats.triangles += packet.cmd.getTriangleCount();
+    }
+
+    if (currentVAO != 0) {
+        glBindVertexArray(0);
+        stats.vaoBinds++;
+    }
+}
+
+uint32_t RenderQueue::denseIndex(std::unordered_map<GLuint, uint32_t>& indices, GLuint name, uint32_t limit) {
+    auto it = indices.find(name);
+    if (it != indices.end()) return it->second;
+    uint32_t index = std::min((uint32_t)indices.size(), limit);
+    indices.emplace(name, index);
+    return index;
+}
+
+uint64_t RenderQueue::makeSortKey(uint32_t programIndex, uint32_t vaoIndex, uint16_t material, float depth) {
+    // 非负浮点数的位模式与数值单调一致，取高 24 位即可作为量化深度
+    uint32_t depthBits = 0;
+    if (depth > 0.0f) {
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+        depthBits >>= 8;
+    }
+
+    return ((uint64_t)(programIndex & 0xFFu) << 56)
+         | ((uint64_t)(vaoIndex & 0xFFFFu) << 40)
+         | ((uint64_t)material << 24)
+         | (uint64_t)(depthBits & 0xFFFFFFu);
+}
@@ -0,0 +1,26 @@
+#include <scene/bounds.hpp>
+
+AABB transformAABB(const AABB& local, const glm::mat4& transform) {
+    if (local.isEmpty()) return local;
+
+    // 中心直接变换；半长按矩阵各元素绝对值投影（Arvo）
+    glm::vec3 center = local.getCenter();
+    glm::vec3 extent = local.getExtent();
+    glm::vec3 worldCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+
+    glm::vec3 worldExtent(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        worldExtent[i] = std::abs(transform[0][i]) * extent.x +
+                         std::abs(transform[1][i]) * extent.y +
+                         std::abs(transform[2][i]) * extent.z;
+    }
+    return AABB(worldCenter - worldExtent, worldCenter + worldExtent);
+}
+
+BoundingSphere sphereFromAABB(const AABB& box) {
+    BoundingSphere sphere;
+    if (box.isEmpty()) return sphere;
+    sphere.center = box.getCenter();
+    sphere.radius = glm::length(box.getExtent());
+    return sphere;
+}
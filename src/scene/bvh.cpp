@@ -0,0 +1,381 @@
+#include <scene/bvh.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// ---------------------------- 节点分配 ----------------------------
+
+int DynamicBVH::allocateNode() {
+    if (m_freeList == NULL_NODE) {
+        m_nodes.emplace_back();
+        return (int)m_nodes.size() - 1;
+    }
+    int node = m_freeList;
+    m_freeList = m_nodes[node].left;
+    m_nodes[node] = Node();
+    return node;
+}
+
+void DynamicBVH::freeNode(int node) {
+    m_nodes[node].left = m_freeList;
+    m_nodes[node].height = -1;
+    m_nodes[node].userData = nullptr;
+    m_freeList = node;
+}
+
+// ---------------------------- 增量操作 ----------------------------
+
+int DynamicBVH::insert(const AABB& bounds, void* userData) {
+    int leaf = allocateNode();
+    m_nodes[leaf].bounds = bounds;
+    m_nodes[leaf].userData = userData;
+    m_nodes[leaf].height = 0;
+    insertLeaf(leaf);
+    ++m_leafCount;
+    return leaf;
+}
+
+void DynamicBVH::remove(int proxy) {
+    assert(proxy >= 0 && proxy < (int)m_nodes.size() && m_nodes[proxy].isLeaf());
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --m_leafCount;
+}
+
+void DynamicBVH::update(int proxy, const AABB& bounds) {
+    m_nodes[proxy].bounds = bounds;
+    refitAncestors(m_nodes[proxy].parent);
+}
+
+void DynamicBVH::insertLeaf(int leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // 自顶向下按 SAH 代价选择兄弟节点：
+    // 与当前节点成为兄弟的代价为 2 * 合并面积，继续下行还需为当前节点付出面积增量
+    const AABB leafBounds = m_nodes[leaf].bounds;
+    int index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        float area = node.bounds.getSurfaceArea();
+        float combinedArea = AABB::merge(node.bounds, leafBounds).getSurfaceArea();
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const Node& c = m_nodes[child];
+            float merged = AABB::merge(c.bounds, leafBounds).getSurfaceArea();
+            return (c.isLeaf() ? merged : merged - c.bounds.getSurfaceArea()) + inheritanceCost;
+        };
+        float costLeft = descendCost(node.left);
+        float costRight = descendCost(node.right);
+
+        if (cost < costLeft && cost < costRight) break;
+        index = (costLeft < costRight) ? node.left : node.right;
+    }
+
+    // 新建父节点，替换兄弟节点的位置
+    int sibling = index;
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].left = sibling;
+    m_nodes[newParent].right = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].left == sibling) {
+        m_nodes[oldParent].left = newParent;
+    } else {
+        m_nodes[oldParent].right = newParent;
+    }
+    refitAncestors(newParent);
+}
+
+void DynamicBVH::removeLeaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = (m_nodes[parent].left == leaf) ? m_nodes[parent].right : m_nodes[parent].left;
+
+    // 兄弟节点顶替父节点
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE) {
+        m_root = sibling;
+    } else {
+        if (m_nodes[grandParent].left == parent) {
+            m_nodes[grandParent].left = sibling;
+        } else {
+            m_nodes[grandParent].right = sibling;
+        }
+        refitAncestors(grandParent);
+    }
+    freeNode(parent);
+}
+
+void DynamicBVH::refitAncestors(int node) {
+    while (node != NULL_NODE) {
+        Node& n = m_nodes[node];
+        const Node& left = m_nodes[n.left];
+        const Node& right = m_nodes[n.right];
+        n.bounds = AABB::merge(left.bounds, right.bounds);
+        n.height = 1 + std::max(left.height, right.height);
+        node = n.parent;
+    }
+}
+
+// ---------------------------- 重建 ----------------------------
+
+void DynamicBVH::rebuild() {
+    // 收集叶子，释放所有内部节点
+    m_buildLeaves.clear();
+    m_buildCentroids.resize(m_nodes.size());
+    for (int i = 0; i < (int)m_nodes.size(); ++i) {
+        if (m_nodes[i].height == 0) {
+            m_buildLeaves.push_back(i);
+            m_buildCentroids[i] = m_nodes[i].bounds.getCenter();
+        } else if (m_nodes[i].height > 0) {
+            freeNode(i);
+        }
+    }
+
+    m_root = m_buildLeaves.empty() ? NULL_NODE
+                                   : buildRange(m_buildLeaves.data(), (int)m_buildLeaves.size(), NULL_NODE);
+    m_builtCost = getCost();
+}
+
+bool DynamicBVH::rebuildIfDegraded(float threshold) {
+    float cost = getCost();
+    if (m_builtCost <= 0.0f) {
+        // 首次调用时以当前代价作为基准
+        m_builtCost = cost;
+        return false;
+    }
+    if (cost <= m_builtCost * threshold) return false;
+    rebuild();
+    return true;
+}
+
+int DynamicBVH::buildRange(int* leaves, int count, int parent) {
+    if (count == 1) {
+        m_nodes[leaves[0]].parent = parent;
+        return leaves[0];
+    }
+
+    AABB bounds, centroidBounds;
+    for (int i = 0; i < count; ++i) {
+        const AABB& b = m_nodes[leaves[i]].bounds;
+        bounds.expand(b);
+        centroidBounds.expand(m_buildCentroids[leaves[i]]);
+    }
+
+    // 分箱 SAH：三个轴各 16 个箱，取代价最小的划分
+    constexpr int BIN_COUNT = 16;
+    int bestAxis = -1, bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] <= 1e-6f) continue;
+        float scale = BIN_COUNT / extent[axis];
+
+        AABB binBounds[BIN_COUNT];
+        int binCount[BIN_COUNT] = {};
+        for (int i = 0; i < count; ++i) {
+            int bin = std::min(BIN_COUNT - 1, (int)((m_buildCentroids[leaves[i]][axis] - centroidBounds.min[axis]) * scale));
+            binBounds[bin].expand(m_nodes[leaves[i]].bounds);
+            ++binCount[bin];
+        }
+
+        // 从右向左累积右侧面积与数量
+        float rightArea[BIN_COUNT];
+        int rightCount[BIN_COUNT];
+        AABB accum;
+        int accumCount = 0;
+        for (int i = BIN_COUNT - 1; i > 0; --i) {
+            accum.expand(binBounds[i]);
+            accumCount += binCount[i];
+            rightArea[i] = accumCount ? accum.getSurfaceArea() : 0.0f;
+            rightCount[i] = accumCount;
+        }
+
+        accum = AABB();
+        accumCount = 0;
+        for (int i = 0; i < BIN_COUNT - 1; ++i) {
+            accum.expand(binBounds[i]);
+            accumCount += binCount[i];
+            if (accumCount == 0 || rightCount[i + 1] == 0) continue;
+            float cost = accumCount * accum.getSurfaceArea() + rightCount[i + 1] * rightArea[i + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    int mid;
+    if (bestAxis >= 0) {
+        float scale = BIN_COUNT / extent[bestAxis];
+        float minC = centroidBounds.min[bestAxis];
+        int* middle = std::partition(leaves, leaves + count, [&](int leaf) {
+            int bin = std::min(BIN_COUNT - 1, (int)((m_buildCentroids[leaf][bestAxis] - minC) * scale));
+            return bin <= bestSplit;
+        });
+        mid = (int)(middle - leaves);
+    } else {
+        // 所有中心重合，无法按位置划分：对半分
+        mid = count / 2;
+    }
+
+    int node = allocateNode();
+    m_nodes[node].parent = parent;
+    m_nodes[node].bounds = bounds;
+    int left = buildRange(leaves, mid, node);
+    int right = buildRange(leaves + mid, count - mid, node);
+    m_nodes[node].left = left;
+    m_nodes[node].right = right;
+    m_nodes[node].height = 1 + std::max(m_nodes[left].height, m_nodes[right].height);
+    return node;
+}
+
+// ---------------------------- 统计 ----------------------------
+
+float DynamicBVH::getCost() const {
+    if (m_root == NULL_NODE) return 0.0f;
+    float rootArea = m_nodes[m_root].bounds.getSurfaceArea();
+    if (rootArea <= 0.0f) return 0.0f;
+
+    float total = 0.0f;
+    for (const Node& node : m_nodes) {
+        if (node.height > 0) total += node.bounds.getSurfaceArea();
+    }
+    return total / rootArea;
+}
+
+int DynamicBVH::getHeight() const {
+    return m_root == NULL_NODE ? 0 : m_nodes[m_root].height;
+}
+
+// ---------------------------- 查询 ----------------------------
+
+namespace {
+
+enum class Containment { OUTSIDE, INTERSECT, INSIDE };
+
+Containment classify(const Frustum& frustum, const AABB& box) {
+    Containment result = Containment::INSIDE;
+    for (int i = 0; i < Frustum::PLANE_COUNT; ++i) {
+        const glm::vec4& plane = frustum.getPlane(i);
+        // 法线方向上最远与最近的顶点
+        glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                           plane.y >= 0.0f ? box.max.y : box.min.y,
+                           plane.z >= 0.0f ? box.max.z : box.min.z);
+        glm::vec3 negative(plane.x >= 0.0f ? box.min.x : box.max.x,
+                           plane.y >= 0.0f ? box.min.y : box.max.y,
+                           plane.z >= 0.0f ? box.min.z : box.max.z);
+        if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f) {
+            return Containment::OUTSIDE;
+        }
+        if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f) {
+            result = Containment::INTERSECT;
+        }
+    }
+    return result;
+}
+
+// 射线与包围盒的进入距离；未命中返回 +inf
+float intersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& invDir, float maxDistance) {
+    float t0 = 0.0f, t1 = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        float tNear = (box.min[axis] - origin[axis]) * invDir[axis];
+        float tFar = (box.max[axis] - origin[axis]) * invDir[axis];
+        if (tNear > tFar) std::swap(tNear, tFar);
+        t0 = tNear > t0 ? tNear : t0;
+        t1 = tFar < t1 ? tFar : t1;
+        if (t0 > t1) return std::numeric_limits<float>::infinity();
+    }
+    return t0;
+}
+
+} // namespace
+
+void DynamicBVH::queryFrustum(const Frustum& frustum, std::vector<void*>& out) const {
+    if (m_root == NULL_NODE) return;
+
+    // 栈中以 ~node 标记已知完全在视锥体内的子树
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty()) {
+        int entry = m_stack.back();
+        m_stack.pop_back();
+
+        bool inside = entry < 0;
+        int index = inside ? ~entry : entry;
+        const Node& node = m_nodes[index];
+
+        if (!inside) {
+            Containment c = classify(frustum, node.bounds);
+            if (c == Containment::OUTSIDE) continue;
+            inside = (c == Containment::INSIDE);
+        }
+
+        if (node.isLeaf()) {
+            out.push_back(node.userData);
+        } else {
+            m_stack.push_back(inside ? ~node.left : node.left);
+            m_stack.push_back(inside ? ~node.right : node.right);
+        }
+    }
+}
+
+void* DynamicBVH::raycast(const Ray& ray, float maxDistance, float* hitDistance) const {
+    if (m_root == NULL_NODE) return nullptr;
+
+    glm::vec3 invDir(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+    // 未命中返回 +inf，因此最大距离需为有限值
+    float best = std::min(maxDistance, std::numeric_limits<float>::max());
+    void* hit = nullptr;
+
+    m_stack.clear();
+    if (intersectRay(m_nodes[m_root].bounds, ray.origin, invDir, best) <= best) {
+        m_stack.push_back(m_root);
+    }
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        if (node.isLeaf()) {
+            float t = intersectRay(node.bounds, ray.origin, invDir, best);
+            if (t < best) {
+                best = t;
+                hit = node.userData;
+            }
+            continue;
+        }
+
+        // 先访问较近的子节点（后入栈），以便尽早缩短 best
+        float tLeft = intersectRay(m_nodes[node.left].bounds, ray.origin, invDir, best);
+        float tRight = intersectRay(m_nodes[node.right].bounds, ray.origin, invDir, best);
+        if (tLeft <= tRight) {
+            if (tRight <= best) m_stack.push_back(node.right);
+            if (tLeft <= best) m_stack.push_back(node.left);
+        } else {
+            if (tLeft <= best) m_stack.push_back(node.left);
+            if (tRight <= best) m_stack.push_back(node.right);
+        }
+    }
+
+    if (hit && hitDistance) *hitDistance = best;
+    return hit;
+}
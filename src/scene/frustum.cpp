@@ -0,0 +1,108 @@
+#include <scene/frustum.hpp>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_USE_SSE
+#endif
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // glm 为列主序：第 i 行为 (m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    m_planes[PLANE_LEFT]   = row3 + row0;
+    m_planes[PLANE_RIGHT]  = row3 - row0;
+    m_planes[PLANE_BOTTOM] = row3 + row1;
+    m_planes[PLANE_TOP]    = row3 - row1;
+    m_planes[PLANE_NEAR]   = row3 + row2;
+    m_planes[PLANE_FAR]    = row3 - row2;
+
+    for (auto& plane : m_planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = plane / length;
+    }
+}
+
+bool Frustum::testSphere(const glm::vec3& center, float radius) const {
+    for (const auto& plane : m_planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::testAABB(const AABB& box) const {
+    for (const auto& plane : m_planes) {
+        // 取包围盒在平面法线方向上最远的顶点
+        glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                           plane.y >= 0.0f ? box.max.y : box.min.y,
+                           plane.z >= 0.0f ? box.max.z : box.min.z);
+        if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::testSpheres(const float* x, const float* y, const float* z, const float* radius,
+                          size_t count, uint8_t* visible) const {
+    size_t i = 0;
+
+#if defined(__AVX__)
+    __m256 px[PLANE_COUNT], py[PLANE_COUNT], pz[PLANE_COUNT], pw[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; ++p) {
+        px[p] = _mm256_set1_ps(m_planes[p].x);
+        py[p] = _mm256_set1_ps(m_planes[p].y);
+        pz[p] = _mm256_set1_ps(m_planes[p].z);
+        pw[p] = _mm256_set1_ps(m_planes[p].w);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(x + i);
+        __m256 cy = _mm256_loadu_ps(y + i);
+        __m256 cz = _mm256_loadu_ps(z + i);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < PLANE_COUNT; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[p], cx), _mm256_mul_ps(py[p], cy)),
+                                     _mm256_add_ps(_mm256_mul_ps(pz[p], cz), pw[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        for (int k = 0; k < 8; ++k) visible[i + k] = (uint8_t)((mask >> k) & 1);
+    }
+#elif defined(FRUSTUM_USE_SSE)
+    __m128 px[PLANE_COUNT], py[PLANE_COUNT], pz[PLANE_COUNT], pw[PLANE_COUNT];
+    for (int p = 0; p < PLANE_COUNT; ++p) {
+        px[p] = _mm_set1_ps(m_planes[p].x);
+        py[p] = _mm_set1_ps(m_planes[p].y);
+        pz[p] = _mm_set1_ps(m_planes[p].z);
+        pw[p] = _mm_set1_ps(m_planes[p].w);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(x + i);
+        __m128 cy = _mm_loadu_ps(y + i);
+        __m128 cz = _mm_loadu_ps(z + i);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < PLANE_COUNT; ++p) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+                                  _mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; ++k) visible[i + k] = (uint8_t)((mask >> k) & 1);
+    }
+#endif
+
+    // 剩余部分（或无 SIMD 时全部）逐个测试
+    for (; i < count; ++i) {
+        visible[i] = testSphere(glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+    }
+}
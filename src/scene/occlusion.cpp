@@ -0,0 +1,280 @@
+#include <scene/occlusion.hpp>
+#include <basic/trace.hpp>
+#include <basic/worker_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE
+#endif
+
+OcclusionCuller::OcclusionCuller(int width, int height, WorkerPool* pool)
+    : m_pool(pool ? pool : &WorkerPool::shared()) {
+    m_width = (width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE;
+    m_height = (height + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE;
+    m_tilesX = m_width / TILE_SIZE;
+    m_tilesY = m_height / TILE_SIZE;
+    m_tileBins.resize(m_tilesX * m_tilesY);
+
+    // 分配 mip 链，直到 1x1。每层尺寸向上取整：奇数尺寸的最后一行/列单独成一个纹素，
+    // 这样第 L 层纹素 x 恰好对应第 0 层像素 [x << L, (x + 1) << L)，不会漏掉任何像素
+    int w = m_width, h = m_height;
+    while (true) {
+        m_mips.push_back(MipLevel{ w, h, std::vector<float>((size_t)w * h, 1.0f) });
+        if (w == 1 && h == 1) break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& viewProjection) {
+    m_viewProjection = viewProjection;
+    m_triangles.clear();
+    for (auto& bin : m_tileBins) bin.clear();
+}
+
+void OcclusionCuller::addOccluder(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices,
+                                  const glm::mat4& model) {
+    glm::mat4 mvp = m_viewProjection * model;
+    m_clipVertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        m_clipVertices[i] = mvp * glm::vec4(vertices[i], 1.0f);
+    }
+
+    const float nearW = 1e-5f;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::vec4* v[3] = { &m_clipVertices[indices[i]], &m_clipVertices[indices[i + 1]],
+                                  &m_clipVertices[indices[i + 2]] };
+        // 与近平面相交或位于摄像机后方的三角形直接丢弃（保守）
+        if (v[0]->w < nearW || v[1]->w < nearW || v[2]->w < nearW) continue;
+
+        ScreenTriangle tri;
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+        bool beyondFar = true;
+        for (int k = 0; k < 3; ++k) {
+            float invW = 1.0f / v[k]->w;
+            tri.x[k] = (v[k]->x * invW * 0.5f + 0.5f) * m_width;
+            tri.y[k] = (v[k]->y * invW * 0.5f + 0.5f) * m_height;
+            tri.z[k] = v[k]->z * invW * 0.5f + 0.5f;
+            beyondFar = beyondFar && tri.z[k] > 1.0f;
+            minX = std::min(minX, tri.x[k]); maxX = std::max(maxX, tri.x[k]);
+            minY = std::min(minY, tri.y[k]); maxY = std::max(maxY, tri.y[k]);
+        }
+        if (beyondFar || maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height) continue;
+
+        tri.minTileX = std::max(0, (int)minX / TILE_SIZE);
+        tri.minTileY = std::max(0, (int)minY / TILE_SIZE);
+        tri.maxTileX = std::min(m_tilesX - 1, (int)maxX / TILE_SIZE);
+        tri.maxTileY = std::min(m_tilesY - 1, (int)maxY / TILE_SIZE);
+
+        // 分箱到覆盖的瓦片
+        uint32_t index = (uint32_t)m_triangles.size();
+        m_triangles.push_back(tri);
+        for (int ty = tri.minTileY; ty <= tri.maxTileY; ++ty) {
+            for (int tx = tri.minTileX; tx <= tri.maxTileX; ++tx) {
+                m_tileBins[tx + ty * m_tilesX].push_back(index);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::rasterize() {
+    std::fill(m_mips[0].depth.begin(), m_mips[0].depth.end(), 1.0f);
+
+    // 各线程从原子计数器领取瓦片；瓦片互不重叠，写深度无需加锁
+    int tileCount = m_tilesX * m_tilesY;
+    std::atomic<int> nextTile{ 0 };
+    auto worker = [&](unsigned) {
+        for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+            rasterizeTile(tile);
+        }
+    };
+
+    unsigned threads = m_threadCount ? std::min(m_threadCount, m_pool->getThreadCount()) : m_pool->getThreadCount();
+    threads = std::min(threads, (unsigned)tileCount);
+    if (threads <= 1 || m_triangles.empty()) {
+        worker(0);
+        return;
+    }
+    m_pool->parallelFor(threads, worker);
+}
+
+void OcclusionCuller::rasterizeTile(int tileIndex) {
+    TRACE_ZONE("OcclusionCuller::rasterizeTile");
+    int tx = tileIndex % m_tilesX;
+    int ty = tileIndex / m_tilesX;
+    int x0 = tx * TILE_SIZE, y0 = ty * TILE_SIZE;
+    for (uint32_t index : m_tileBins[tileIndex]) {
+        rasterizeTriangle(m_triangles[index], x0, y0, x0 + TILE_SIZE, y0 + TILE_SIZE);
+    }
+}
+
+void OcclusionCuller::rasterizeTriangle(const ScreenTriangle& tri, int tileX0, int tileY0, int tileX1, int tileY1) {
+    const float* x = tri.x;
+    const float* y = tri.y;
+    const float* z = tri.z;
+
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::fabs(area) < 1e-8f) return;
+    // 两种绕序都光栅化：统一为正面积
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+
+    // 边函数 E_i(px, py) = A_i * px + B_i * py + C_i，(A_i, B_i) 指向三角形内部。
+    // 系数按端点的固定顺序计算再乘以符号，相邻三角形共享的边得到严格相反的 E，
+    // 不会因舍入误差同时落在两侧之外而留下缝隙。
+    // 左上填充规则（以深度缓冲的行号方向为"下"）：E > 0 时覆盖；E == 0 时只有左边（A > 0）
+    // 与上边（A == 0 且 B > 0）覆盖，共享的边只归属其中一个三角形
+    float A[3], B[3], C[3];
+    bool topLeft[3];
+    for (int i = 0; i < 3; ++i) {
+        int a = (i + 1) % 3, b = (i + 2) % 3;
+        float edgeSign = sign;
+        if (x[b] < x[a] || (x[b] == x[a] && y[b] < y[a])) {
+            std::swap(a, b);
+            edgeSign = -edgeSign;
+        }
+        float edgeA = y[a] - y[b];
+        float edgeB = x[b] - x[a];
+        float edgeC = -(edgeA * x[a] + edgeB * y[a]);
+        A[i] = edgeA * edgeSign;
+        B[i] = edgeB * edgeSign;
+        C[i] = edgeC * edgeSign;
+        topLeft[i] = A[i] > 0.0f || (A[i] == 0.0f && B[i] > 0.0f);
+    }
+
+    // 深度平面 z(px, py) = zA * px + zB * py + zC（NDC 深度在屏幕空间内线性）
+    float zA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+    float zB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+    float zC = z[0] - zA * x[0] - zB * y[0];
+
+    // 三角形包围盒与瓦片求交，X 起点对齐到 4
+    int minX = std::max(tileX0, (int)std::floor(std::min({ x[0], x[1], x[2] })));
+    int maxX = std::min(tileX1, (int)std::ceil(std::max({ x[0], x[1], x[2] })));
+    int minY = std::max(tileY0, (int)std::floor(std::min({ y[0], y[1], y[2] })));
+    int maxY = std::min(tileY1, (int)std::ceil(std::max({ y[0], y[1], y[2] })));
+    if (minX >= maxX || minY >= maxY) return;
+    minX &= ~3;
+
+    float* depth = m_mips[0].depth.data();
+
+#if defined(OCCLUSION_USE_SSE)
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 vA[3], vB[3], vC[3], vTopLeft[3];
+    for (int i = 0; i < 3; ++i) {
+        vA[i] = _mm_set1_ps(A[i]);
+        vB[i] = _mm_set1_ps(B[i]);
+        vC[i] = _mm_set1_ps(C[i]);
+        vTopLeft[i] = _mm_castsi128_ps(_mm_set1_epi32(topLeft[i] ? -1 : 0));
+    }
+    // E > 0，或 E == 0 且为左上边
+    auto covered = [&](__m128 e, int i) {
+        return _mm_or_ps(_mm_cmpgt_ps(e, zero), _mm_and_ps(_mm_cmpeq_ps(e, zero), vTopLeft[i]));
+    };
+    const __m128 vzA = _mm_set1_ps(zA), vzB = _mm_set1_ps(zB), vzC = _mm_set1_ps(zC);
+
+    for (int py = minY; py < maxY; ++py) {
+        __m128 fy = _mm_set1_ps(py + 0.5f);
+        __m128 rowE0 = _mm_add_ps(_mm_mul_ps(vB[0], fy), vC[0]);
+        __m128 rowE1 = _mm_add_ps(_mm_mul_ps(vB[1], fy), vC[1]);
+        __m128 rowE2 = _mm_add_ps(_mm_mul_ps(vB[2], fy), vC[2]);
+        __m128 rowZ = _mm_add_ps(_mm_mul_ps(vzB, fy), vzC);
+        float* row = depth + (size_t)py * m_width;
+
+        for (int px = minX; px < maxX; px += 4) {
+            __m128 fx = _mm_add_ps(_mm_set1_ps((float)px), offsets);
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(vA[0], fx), rowE0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(vA[1], fx), rowE1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(vA[2], fx), rowE2);
+            __m128 inside = _mm_and_ps(_mm_and_ps(covered(e0, 0), covered(e1, 1)), covered(e2, 2));
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            __m128 pz = _mm_add_ps(_mm_mul_ps(vzA, fx), rowZ);
+            __m128 old = _mm_loadu_ps(row + px);
+            __m128 nearest = _mm_min_ps(old, pz);
+            _mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+        }
+    }
+#else
+    for (int py = minY; py < maxY; ++py) {
+        float fy = py + 0.5f;
+        float* row = depth + (size_t)py * m_width;
+        for (int px = minX; px < maxX; ++px) {
+            float fx = px + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < 3; ++i) {
+                float e = A[i] * fx + B[i] * fy + C[i];
+                inside = inside && (e > 0.0f || (e == 0.0f && topLeft[i]));
+            }
+            if (!inside) continue;
+            float pz = zA * fx + zB * fy + zC;
+            if (pz < row[px]) row[px] = pz;
+        }
+    }
+#endif
+}
+
+void OcclusionCuller::buildHiZ() {
+    // 每个 mip 纹素取下一层对应 2x2 区域的最大深度（最远），测试时保持保守；
+    // 上一层尺寸为奇数时最后一个纹素只覆盖 1 列/行（下标截断到边界）
+    for (size_t level = 1; level < m_mips.size(); ++level) {
+        const MipLevel& src = m_mips[level - 1];
+        MipLevel& dst = m_mips[level];
+        for (int y = 0; y < dst.height; ++y) {
+            int sy0 = std::min(y * 2, src.height - 1);
+            int sy1 = std::min(y * 2 + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                int sx0 = std::min(x * 2, src.width - 1);
+                int sx1 = std::min(x * 2 + 1, src.width - 1);
+                float d = std::max(std::max(src.depth[sy0 * src.width + sx0], src.depth[sy0 * src.width + sx1]),
+                                   std::max(src.depth[sy1 * src.width + sx0], src.depth[sy1 * src.width + sx1]));
+                dst.depth[y * dst.width + x] = d;
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const AABB& worldBounds) const {
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1e30f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 1) ? worldBounds.max.x : worldBounds.min.x,
+                         (i & 2) ? worldBounds.max.y : worldBounds.min.y,
+                         (i & 4) ? worldBounds.max.z : worldBounds.min.z);
+        glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.0f);
+        // 包围盒跨过近平面：无法可靠投影，视为可见
+        if (clip.w < 1e-5f) return true;
+        float invW = 1.0f / clip.w;
+        float sx = (clip.x * invW * 0.5f + 0.5f) * m_width;
+        float sy = (clip.y * invW * 0.5f + 0.5f) * m_height;
+        float sz = clip.z * invW * 0.5f + 0.5f;
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, sz);
+    }
+
+    // 屏幕外的部分交给视锥体剔除处理
+    int x0 = std::max(0, (int)std::floor(minX));
+    int y0 = std::max(0, (int)std::floor(minY));
+    int x1 = std::min(m_width - 1, (int)std::ceil(maxX));
+    int y1 = std::min(m_height - 1, (int)std::ceil(maxY));
+    if (x0 > x1 || y0 > y1) return true;
+
+    // 选择使矩形覆盖不超过约 4x4 纹素的层级
+    int extent = std::max(x1 - x0, y1 - y0) + 1;
+    int level = 0;
+    while ((extent >> level) > 4 && level + 1 < (int)m_mips.size()) ++level;
+
+    // 各层尺寸向上取整，像素 p 落在第 level 层的纹素 p >> level 中
+    const MipLevel& mip = m_mips[level];
+    int lx0 = std::min(x0 >> level, mip.width - 1), lx1 = std::min(x1 >> level, mip.width - 1);
+    int ly0 = std::min(y0 >> level, mip.height - 1), ly1 = std::min(y1 >> level, mip.height - 1);
+    for (int y = ly0; y <= ly1; ++y) {
+        for (int x = lx0; x <= lx1; ++x) {
+            // 遮挡体最远深度不比物体最近深度更近：可能可见
+            if (mip.depth[y * mip.width + x] >= minZ) return true;
+        }
+    }
+    return false;
+}
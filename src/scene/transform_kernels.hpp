@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+
+// TransformSystem 内部使用的批量矩阵内核（不对外公开）
+
+/**
+ * @brief 内核输入：SoA 分量数组（旋转为欧拉角，度）
+ */
+struct TransformSoA {
+    const float* px; const float* py; const float* pz;
+    const float* rx; const float* ry; const float* rz;
+    const float* sx; const float* sy; const float* sz;
+};
+
+/**
+ * @brief 标量内核，计算 [begin, end) 的矩阵
+ * @param out 列主序 4x4 矩阵数组（每个 16 个 float）
+ */
+void composeTransformsScalar(const TransformSoA& in, size_t begin, size_t end, float* out);
+
+/**
+ * @brief SSE 内核，每次 4 个；不足 4 个的尾部交给标量内核
+ * @param streaming 使用非临时写（绕过缓存），适合一次写出远超缓存容量的结果
+ */
+void composeTransformsSSE(const TransformSoA& in, size_t begin, size_t end, float* out, bool streaming);
+
+/**
+ * @brief AVX2 内核，每次 8 个（单独的编译单元，以 -mavx2 -mfma 编译）
+ */
+void composeTransformsAVX2(const TransformSoA& in, size_t begin, size_t end, float* out, bool streaming);
+
+/**
+ * @brief AVX2 内核是否被编译进来（编译器不支持时为 false）
+ */
+bool isAVX2KernelCompiled();
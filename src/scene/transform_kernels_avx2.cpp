@@ -0,0 +1,165 @@
+// AVX2 批量矩阵内核：本文件单独以 -mavx2 -mfma（MSVC 为 /arch:AVX2）编译，
+// 只有运行时检测到 CPU 支持时才会被 TransformSystem 调用。
+#include "transform_kernels.hpp"
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#if defined(__FMA__) || defined(_MSC_VER)
+#define MUL_ADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#define MUL_SUB(a, b, c) _mm256_fmsub_ps(a, b, c)
+#define NEG_MUL_ADD(a, b, c) _mm256_fnmadd_ps(a, b, c)
+#else
+#define MUL_ADD(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#define MUL_SUB(a, b, c) _mm256_sub_ps(_mm256_mul_ps(a, b), c)
+#define NEG_MUL_ADD(a, b, c) _mm256_sub_ps(c, _mm256_mul_ps(a, b))
+#endif
+
+namespace {
+
+constexpr float DEG_TO_RAD = 0.017453292519943295f;
+
+/**
+ * @brief 8 路 sin/cos（与 SSE 版本相同的 Cephes 多项式）
+ */
+inline void sincos8(__m256 x, __m256& outSin, __m256& outCos) {
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    __m256 signSin = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x);
+
+    __m256i q = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+    q = _mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(q);
+
+    __m256 swapSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(4)), 29));
+    __m256 polyMask = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    __m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(q, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    signSin = _mm256_xor_ps(signSin, swapSin);
+
+    x = NEG_MUL_ADD(y, _mm256_set1_ps(0.78515625f), x);
+    x = NEG_MUL_ADD(y, _mm256_set1_ps(2.4187564849853515625e-4f), x);
+    x = NEG_MUL_ADD(y, _mm256_set1_ps(3.77489497744594108e-8f), x);
+    __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 c = _mm256_set1_ps(2.443315711809948e-5f);
+    c = MUL_ADD(c, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    c = MUL_ADD(c, z, _mm256_set1_ps(4.166664568298827e-2f));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+    c = NEG_MUL_ADD(z, _mm256_set1_ps(0.5f), c);
+    c = _mm256_add_ps(c, _mm256_set1_ps(1.0f));
+
+    __m256 s = _mm256_set1_ps(-1.9515295891e-4f);
+    s = MUL_ADD(s, z, _mm256_set1_ps(8.3321608736e-3f));
+    s = MUL_ADD(s, z, _mm256_set1_ps(-1.6666654611e-1f));
+    s = MUL_ADD(_mm256_mul_ps(s, z), x, x);
+
+    __m256 sinValue = _mm256_blendv_ps(c, s, polyMask);
+    __m256 cosValue = _mm256_blendv_ps(s, c, polyMask);
+    outSin = _mm256_xor_ps(sinValue, signSin);
+    outCos = _mm256_xor_ps(cosValue, signCos);
+}
+
+/**
+ * @brief 8x8 转置：输入第 k 个寄存器为 8 个矩阵的第 k 个元素，输出第 i 个寄存器为第 i 个矩阵的 8 个元素
+ */
+inline void transpose8(__m256* r) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+} // namespace
+
+void composeTransformsAVX2(const TransformSoA& in, size_t begin, size_t end, float* out, bool streaming) {
+    // 矩阵数组只保证 16 字节对齐，非临时写按 128 位进行
+    streaming = streaming && ((uintptr_t)out & 15) == 0;
+    const __m256 toRad = _mm256_set1_ps(DEG_TO_RAD);
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 sa, ca, sb, cb, sc, cc;
+        sincos8(_mm256_mul_ps(_mm256_loadu_ps(in.rx + i), toRad), sa, ca);
+        sincos8(_mm256_mul_ps(_mm256_loadu_ps(in.ry + i), toRad), sb, cb);
+        sincos8(_mm256_mul_ps(_mm256_loadu_ps(in.rz + i), toRad), sc, cc);
+        __m256 sx = _mm256_loadu_ps(in.sx + i);
+        __m256 sy = _mm256_loadu_ps(in.sy + i);
+        __m256 sz = _mm256_loadu_ps(in.sz + i);
+
+        __m256 sasb = _mm256_mul_ps(sa, sb);
+        __m256 casb = _mm256_mul_ps(ca, sb);
+
+        // 前两列（元素 0~7）与后两列（元素 8~15）各做一次 8x8 转置
+        __m256 lo[8], hi[8];
+        lo[0] = _mm256_mul_ps(_mm256_mul_ps(cb, cc), sx);
+        lo[1] = _mm256_mul_ps(MUL_ADD(sasb, cc, _mm256_mul_ps(ca, sc)), sx);
+        lo[2] = _mm256_mul_ps(MUL_SUB(sa, sc, _mm256_mul_ps(casb, cc)), sx);
+        lo[3] = zero;
+        lo[4] = _mm256_mul_ps(_mm256_sub_ps(zero, _mm256_mul_ps(cb, sc)), sy);
+        lo[5] = _mm256_mul_ps(MUL_SUB(ca, cc, _mm256_mul_ps(sasb, sc)), sy);
+        lo[6] = _mm256_mul_ps(MUL_ADD(casb, sc, _mm256_mul_ps(sa, cc)), sy);
+        lo[7] = zero;
+        hi[0] = _mm256_mul_ps(sb, sz);
+        hi[1] = _mm256_mul_ps(_mm256_sub_ps(zero, _mm256_mul_ps(sa, cb)), sz);
+        hi[2] = _mm256_mul_ps(_mm256_mul_ps(ca, cb), sz);
+        hi[3] = zero;
+        hi[4] = _mm256_loadu_ps(in.px + i);
+        hi[5] = _mm256_loadu_ps(in.py + i);
+        hi[6] = _mm256_loadu_ps(in.pz + i);
+        hi[7] = _mm256_set1_ps(1.0f);
+
+        transpose8(lo);
+        transpose8(hi);
+
+        float* m = out + i * 16;
+        if (streaming) {
+            for (int k = 0; k < 8; ++k) {
+                _mm_stream_ps(m + k * 16, _mm256_castps256_ps128(lo[k]));
+                _mm_stream_ps(m + k * 16 + 4, _mm256_extractf128_ps(lo[k], 1));
+                _mm_stream_ps(m + k * 16 + 8, _mm256_castps256_ps128(hi[k]));
+                _mm_stream_ps(m + k * 16 + 12, _mm256_extractf128_ps(hi[k], 1));
+            }
+        } else {
+            for (int k = 0; k < 8; ++k) {
+                _mm256_storeu_ps(m + k * 16, lo[k]);
+                _mm256_storeu_ps(m + k * 16 + 8, hi[k]);
+            }
+        }
+    }
+    if (streaming) _mm_sfence();
+    composeTransformsScalar(in, i, end, out);
+}
+
+bool isAVX2KernelCompiled() { return true; }
+
+#else
+
+void composeTransformsAVX2(const TransformSoA& in, size_t begin, size_t end, float* out, bool streaming) {
+    composeTransformsSSE(in, begin, end, out, streaming);
+}
+
+bool isAVX2KernelCompiled() { return false; }
+
+#endif
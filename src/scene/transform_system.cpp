@@ -0,0 +1,359 @@
+#include <scene/transform_system.hpp>
+#include "transform_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRANSFORM_USE_SSE
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace {
+constexpr float DEG_TO_RAD = 0.017453292519943295f;
+}
+
+// ---------------------------------------------------------------------------
+// 内核
+// ---------------------------------------------------------------------------
+
+void composeTransformsScalar(const TransformSoA& in, size_t begin, size_t end, float* out) {
+    for (size_t i = begin; i < end; ++i) {
+        float ax = in.rx[i] * DEG_TO_RAD, ay = in.ry[i] * DEG_TO_RAD, az = in.rz[i] * DEG_TO_RAD;
+        float sa = std::sin(ax), ca = std::cos(ax);
+        float sb = std::sin(ay), cb = std::cos(ay);
+        float sc = std::sin(az), cc = std::cos(az);
+
+        // R = Rx * Ry * Rz，按列乘以缩放
+        float* m = out + i * 16;
+        m[0] = cb * cc * in.sx[i];
+        m[1] = (sa * sb * cc + ca * sc) * in.sx[i];
+        m[2] = (sa * sc - ca * sb * cc) * in.sx[i];
+        m[3] = 0.0f;
+        m[4] = -cb * sc * in.sy[i];
+        m[5] = (ca * cc - sa * sb * sc) * in.sy[i];
+        m[6] = (ca * sb * sc + sa * cc) * in.sy[i];
+        m[7] = 0.0f;
+        m[8] = sb * in.sz[i];
+        m[9] = -sa * cb * in.sz[i];
+        m[10] = ca * cb * in.sz[i];
+        m[11] = 0.0f;
+        m[12] = in.px[i];
+        m[13] = in.py[i];
+        m[14] = in.pz[i];
+        m[15] = 1.0f;
+    }
+}
+
+#if defined(TRANSFORM_USE_SSE)
+namespace {
+
+/**
+ * @brief 4 路 sin/cos（Cephes 多项式，|x| < 8192 时误差约 1 ulp 量级）
+ */
+inline void sincos4(__m128 x, __m128& outSin, __m128& outCos) {
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    __m128 signSin = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    // 以 pi/4 为单位做区间缩减，象限号取偶数
+    __m128i q = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+    q = _mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(q);
+
+    __m128 swapSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(4)), 29));
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    __m128 signCos = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(q, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    signSin = _mm_xor_ps(signSin, swapSin);
+
+    // x -= y * pi/4（分三段保证精度）
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 c = _mm_set1_ps(2.443315711809948e-5f);
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(-1.388731625493765e-3f));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+    __m128 s = _mm_set1_ps(-1.9515295891e-4f);
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(8.3321608736e-3f));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+    // 象限为 1、2 时 sin/cos 多项式互换
+    __m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, s), _mm_andnot_ps(polyMask, c));
+    __m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, c), _mm_andnot_ps(polyMask, s));
+    outSin = _mm_xor_ps(sinValue, signSin);
+    outCos = _mm_xor_ps(cosValue, signCos);
+}
+
+} // namespace
+
+void composeTransformsSSE(const TransformSoA& in, size_t begin, size_t end, float* out, bool streaming) {
+    // 非临时写要求 16 字节对齐
+    streaming = streaming && ((uintptr_t)out & 15) == 0;
+    const __m128 toRad = _mm_set1_ps(DEG_TO_RAD);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 sa, ca, sb, cb, sc, cc;
+        sincos4(_mm_mul_ps(_mm_loadu_ps(in.rx + i), toRad), sa, ca);
+        sincos4(_mm_mul_ps(_mm_loadu_ps(in.ry + i), toRad), sb, cb);
+        sincos4(_mm_mul_ps(_mm_loadu_ps(in.rz + i), toRad), sc, cc);
+        __m128 sx = _mm_loadu_ps(in.sx + i);
+        __m128 sy = _mm_loadu_ps(in.sy + i);
+        __m128 sz = _mm_loadu_ps(in.sz + i);
+
+        __m128 sasb = _mm_mul_ps(sa, sb);
+        __m128 casb = _mm_mul_ps(ca, sb);
+
+        // 16 个元素，每个寄存器存放 4 个矩阵的同一元素
+        __m128 e[16];
+        e[0] = _mm_mul_ps(_mm_mul_ps(cb, cc), sx);
+        e[1] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(sasb, cc), _mm_mul_ps(ca, sc)), sx);
+        e[2] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sa, sc), _mm_mul_ps(casb, cc)), sx);
+        e[3] = zero;
+        e[4] = _mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(cb, sc)), sy);
+        e[5] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ca, cc), _mm_mul_ps(sasb, sc)), sy);
+        e[6] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(casb, sc), _mm_mul_ps(sa, cc)), sy);
+        e[7] = zero;
+        e[8] = _mm_mul_ps(sb, sz);
+        e[9] = _mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(sa, cb)), sz);
+        e[10] = _mm_mul_ps(_mm_mul_ps(ca, cb), sz);
+        e[11] = zero;
+        e[12] = _mm_loadu_ps(in.px + i);
+        e[13] = _mm_loadu_ps(in.py + i);
+        e[14] = _mm_loadu_ps(in.pz + i);
+        e[15] = one;
+
+        // 每 4 个元素（一列）转置后写回各自的矩阵
+        float* m = out + i * 16;
+        for (int column = 0; column < 4; ++column) {
+            __m128 r0 = e[column * 4 + 0], r1 = e[column * 4 + 1];
+            __m128 r2 = e[column * 4 + 2], r3 = e[column * 4 + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            if (streaming) {
+                _mm_stream_ps(m + 0 * 16 + column * 4, r0);
+                _mm_stream_ps(m + 1 * 16 + column * 4, r1);
+                _mm_stream_ps(m + 2 * 16 + column * 4, r2);
+                _mm_stream_ps(m + 3 * 16 + column * 4, r3);
+            } else {
+                _mm_storeu_ps(m + 0 * 16 + column * 4, r0);
+                _mm_storeu_ps(m + 1 * 16 + column * 4, r1);
+                _mm_storeu_ps(m + 2 * 16 + column * 4, r2);
+                _mm_storeu_ps(m + 3 * 16 + column * 4, r3);
+            }
+        }
+    }
+    if (streaming) _mm_sfence();
+    composeTransformsScalar(in, i, end, out);
+}
+#else
+void composeTransformsSSE(const TransformSoA& in, size_t begin, size_t end, float* out, bool) {
+    composeTransformsScalar(in, begin, end, out);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// TransformSystem
+// ---------------------------------------------------------------------------
+
+TransformSystem::TransformSystem(size_t capacity) : m_simdLevel(detectSimdLevel()) {
+    for (auto* array : { &m_px, &m_py, &m_pz, &m_rx, &m_ry, &m_rz, &m_sx, &m_sy, &m_sz }) {
+        array->reserve(capacity);
+    }
+    m_matrices.reserve(capacity);
+    m_dirty.reserve(capacity);
+    m_handleToIndex.reserve(capacity);
+    m_indexToHandle.reserve(capacity);
+}
+
+TransformSystem::Handle TransformSystem::create(const glm::vec3& position, const glm::vec3& rotation,
+                                                const glm::vec3& scale) {
+    Handle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = (Handle)m_handleToIndex.size();
+        m_handleToIndex.push_back(0);
+    }
+
+    size_t index = m_px.size();
+    m_handleToIndex[handle] = (uint32_t)index;
+    m_indexToHandle.push_back(handle);
+
+    m_px.push_back(position.x); m_py.push_back(position.y); m_pz.push_back(position.z);
+    m_rx.push_back(rotation.x); m_ry.push_back(rotation.y); m_rz.push_back(rotation.z);
+    m_sx.push_back(scale.x); m_sy.push_back(scale.y); m_sz.push_back(scale.z);
+    m_matrices.emplace_back(1.0f);
+    m_dirty.push_back(0);
+    markDirty(index);
+    return handle;
+}
+
+void TransformSystem::destroy(Handle handle) {
+    size_t index = m_handleToIndex[handle];
+    size_t last = m_px.size() - 1;
+
+    if (index != last) {
+        for (auto* array : { &m_px, &m_py, &m_pz, &m_rx, &m_ry, &m_rz, &m_sx, &m_sy, &m_sz }) {
+            (*array)[index] = (*array)[last];
+        }
+        m_matrices[index] = m_matrices[last];
+        m_dirty[index] = m_dirty[last];
+
+        Handle moved = m_indexToHandle[last];
+        m_indexToHandle[index] = moved;
+        m_handleToIndex[moved] = (uint32_t)index;
+    }
+
+    for (auto* array : { &m_px, &m_py, &m_pz, &m_rx, &m_ry, &m_rz, &m_sx, &m_sy, &m_sz }) {
+        array->pop_back();
+    }
+    m_matrices.pop_back();
+    m_dirty.pop_back();
+    m_indexToHandle.pop_back();
+
+    m_handleToIndex[handle] = 0;
+    m_freeHandles.push_back(handle);
+}
+
+void TransformSystem::setPosition(Handle handle, const glm::vec3& position) {
+    size_t i = m_handleToIndex[handle];
+    m_px[i] = position.x; m_py[i] = position.y; m_pz[i] = position.z;
+    markDirty(i);
+}
+
+void TransformSystem::move(Handle handle, const glm::vec3& offset) {
+    size_t i = m_handleToIndex[handle];
+    m_px[i] += offset.x; m_py[i] += offset.y; m_pz[i] += offset.z;
+    markDirty(i);
+}
+
+void TransformSystem::setRotation(Handle handle, const glm::vec3& rotation) {
+    size_t i = m_handleToIndex[handle];
+    m_rx[i] = rotation.x; m_ry[i] = rotation.y; m_rz[i] = rotation.z;
+    markDirty(i);
+}
+
+void TransformSystem::setScale(Handle handle, const glm::vec3& scale) {
+    size_t i = m_handleToIndex[handle];
+    m_sx[i] = scale.x; m_sy[i] = scale.y; m_sz[i] = scale.z;
+    markDirty(i);
+}
+
+glm::vec3 TransformSystem::getPosition(Handle handle) const {
+    size_t i = m_handleToIndex[handle];
+    return glm::vec3(m_px[i], m_py[i], m_pz[i]);
+}
+
+glm::vec3 TransformSystem::getRotation(Handle handle) const {
+    size_t i = m_handleToIndex[handle];
+    return glm::vec3(m_rx[i], m_ry[i], m_rz[i]);
+}
+
+glm::vec3 TransformSystem::getScale(Handle handle) const {
+    size_t i = m_handleToIndex[handle];
+    return glm::vec3(m_sx[i], m_sy[i], m_sz[i]);
+}
+
+void TransformSystem::update() {
+    if (!m_anyDirty) return;
+
+    // 按块扫描脏标记，把连续的脏块合并成一次内核调用
+    const size_t count = size();
+    size_t runBegin = count;
+    for (size_t block = 0; block < count; block += BLOCK_SIZE) {
+        size_t blockEnd = std::min(block + BLOCK_SIZE, count);
+        bool dirty = false;
+        if (blockEnd - block == BLOCK_SIZE) {
+            uint64_t bits;
+            std::memcpy(&bits, &m_dirty[block], sizeof(bits));
+            dirty = bits != 0;
+        } else {
+            for (size_t i = block; i < blockEnd; ++i) dirty |= m_dirty[i] != 0;
+        }
+
+        if (dirty) {
+            if (runBegin == count) runBegin = block;
+        } else if (runBegin != count) {
+            compose(runBegin, block, false);
+            runBegin = count;
+        }
+    }
+    if (runBegin != count) compose(runBegin, count, false);
+
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+}
+
+void TransformSystem::updateAll() {
+    compose(0, size(), size() >= STREAMING_THRESHOLD);
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+}
+
+void TransformSystem::compose(size_t begin, size_t end, bool streaming) {
+    if (begin >= end) return;
+    TransformSoA in = { m_px.data(), m_py.data(), m_pz.data(),
+                        m_rx.data(), m_ry.data(), m_rz.data(),
+                        m_sx.data(), m_sy.data(), m_sz.data() };
+    float* out = &m_matrices.data()[0][0][0];
+
+    switch (m_simdLevel) {
+    case SimdLevel::AVX2: composeTransformsAVX2(in, begin, end, out, streaming); break;
+    case SimdLevel::SSE: composeTransformsSSE(in, begin, end, out, streaming); break;
+    default: composeTransformsScalar(in, begin, end, out); break;
+    }
+}
+
+void TransformSystem::setSimdLevel(SimdLevel level) {
+    m_simdLevel = std::min(level, detectSimdLevel());
+}
+
+SimdLevel TransformSystem::detectSimdLevel() {
+    static const SimdLevel level = [] {
+        bool avx2 = false;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool fma = (info[2] & (1 << 12)) != 0;
+        // 操作系统需保存 YMM 寄存器状态
+        bool ymm = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        avx2 = ymm && fma && (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        if (avx2 && isAVX2KernelCompiled()) return SimdLevel::AVX2;
+#if defined(TRANSFORM_USE_SSE)
+        return SimdLevel::SSE;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }();
+    return level;
+}
+
+const char* TransformSystem::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::SSE: return "SSE";
+    default: return "scalar";
+    }
+}
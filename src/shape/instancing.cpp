@@ -0,0 +1,304 @@
+#include <shape/instancing.hpp>
+#include <basic/trace.hpp>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstddef>
+
+// InstanceBatch implementation
+InstanceBatch::~InstanceBatch() {
+    for (Level& level : m_levels) glDeleteVertexArrays(1, &level.vao);
+    glDeleteBuffers(1, &instanceVBO);
+}
+
+void InstanceBatch::setupGeometry(std::shared_ptr<Mesh> mesh, const glm::vec3& meshScale) {
+    setupGeometry(std::vector<std::shared_ptr<Mesh>>{ std::move(mesh) }, meshScale);
+}
+
+void InstanceBatch::setupGeometry(const std::vector<std::shared_ptr<Mesh>>& lodMeshes, const glm::vec3& meshScale) {
+    m_meshScale = glm::scale(glm::mat4(1.0f), meshScale);
+    m_levelCounts.assign(lodMeshes.size(), 0);
+
+    // 实例缓冲：颜色（location 2）、模型矩阵（location 3~6，每列一个 vec4）与法线矩阵（location 7~9，每列一个 vec3）
+    glGenBuffers(1, &instanceVBO);
+
+    m_levels.resize(lodMeshes.size());
+    for (size_t i = 0; i < lodMeshes.size(); ++i) {
+        Level& level = m_levels[i];
+        level.mesh = lodMeshes[i];
+
+        // 生成并绑定VAO
+        glGenVertexArrays(1, &level.vao);
+        glBindVertexArray(level.vao);
+
+        // 共享几何体（位置+法线）
+        level.mesh->setupVertexAttributes();
+
+        // 实例属性指针在绘制时按该层级实例组的起始位置设置
+        for (GLuint location = 2; location <= 9; ++location) {
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+    }
+
+    // 解绑VAO
+    glBindVertexArray(0);
+}
+
+void InstanceBatch::setInstanceAttributes(GLintptr baseOffset) {
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(baseOffset + offsetof(InstanceData, color)));
+    for (int i = 0; i < 4; ++i) {
+        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(baseOffset + offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+    }
+    for (int i = 0; i < 3; ++i) {
+        glVertexAttribPointer(7 + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(baseOffset + offsetof(InstanceData, normal) + i * sizeof(glm::vec3)));
+    }
+}
+
+size_t InstanceBatch::addInstance(const glm::mat4& model, const glm::vec3& color) {
+    glm::mat4 scaled = model * m_meshScale;
+    m_instances.push_back(InstanceData{ scaled, glm::vec4(color, 1.0f), Shape::computeNormalMatrix(scaled) });
+    m_instanceLevels.push_back(0);
+    m_instanceTransforms.push_back(TransformSystem::INVALID_HANDLE);
+    m_transformQueued.push_back(0);
+    m_levelCounts[0]++;
+    m_dirty = true;
+    m_orderDirty = true;
+    return m_instances.size() - 1;
+}
+
+size_t InstanceBatch::addInstance(const glm::vec3& position, const glm::vec3& color) {
+    return addInstance(position, glm::vec3(0.0f), glm::vec3(1.0f), color);
+}
+
+size_t InstanceBatch::addInstance(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale,
+                                  const glm::vec3& color) {
+    // 矩阵在 updateTransforms() 中批量计算
+    size_t index = addInstance(glm::mat4(1.0f), color);
+    m_instanceTransforms[index] = m_transforms.create(position, rotation, scale);
+    markTransformDirty(index);
+    return index;
+}
+
+void InstanceBatch::setInstanceModel(size_t index, const glm::mat4& model) {
+    if (m_instanceTransforms[index] != TransformSystem::INVALID_HANDLE) {
+        m_transforms.destroy(m_instanceTransforms[index]);
+        m_instanceTransforms[index] = TransformSystem::INVALID_HANDLE;
+    }
+    m_instances[index].model = model * m_meshScale;
+    m_instances[index].normal = Shape::computeNormalMatrix(m_instances[index].model);
+    m_dirty = true;
+    m_orderDirty = true;
+}
+
+void InstanceBatch::setInstancePosition(size_t index, const glm::vec3& position) {
+    if (m_instanceTransforms[index] == TransformSystem::INVALID_HANDLE) return;
+    m_transforms.setPosition(m_instanceTransforms[index], position);
+    markTransformDirty(index);
+}
+
+void InstanceBatch::setInstanceRotation(size_t index, const glm::vec3& rotation) {
+    if (m_instanceTransforms[index] == TransformSystem::INVALID_HANDLE) return;
+    m_transforms.setRotation(m_instanceTransforms[index], rotation);
+    markTransformDirty(index);
+}
+
+void InstanceBatch::setInstanceScale(size_t index, const glm::vec3& scale) {
+    if (m_instanceTransforms[index] == TransformSystem::INVALID_HANDLE) return;
+    m_transforms.setScale(m_instanceTransforms[index], scale);
+    markTransformDirty(index);
+}
+
+void InstanceBatch::markTransformDirty(size_t index) {
+    if (m_transformQueued[index]) return;
+    m_transformQueued[index] = 1;
+    m_dirtyTransforms.push_back(index);
+}
+
+void InstanceBatch::updateTransforms() {
+    if (m_dirtyTransforms.empty()) return;
+    TRACE_ZONE("InstanceBatch::updateTransforms");
+
+    // TransformSystem 只重算脏块；这里把结果乘上网格固有尺寸写回实例数据
+    m_transforms.update();
+    for (size_t index : m_dirtyTransforms) {
+        m_transformQueued[index] = 0;
+        TransformSystem::Handle handle = m_instanceTransforms[index];
+        if (handle == TransformSystem::INVALID_HANDLE) continue;   // 之后改为直接设置矩阵
+        InstanceData& instance = m_instances[index];
+        instance.model = m_transforms.getMatrix(handle) * m_meshScale;
+        instance.normal = Shape::computeNormalMatrix(instance.model);
+    }
+    m_dirtyTransforms.clear();
+    m_dirty = true;
+    m_orderDirty = true;
+}
+
+void InstanceBatch::setInstanceColor(size_t index, const glm::vec3& color) {
+    m_instances[index].color = glm::vec4(color, 1.0f);
+    m_dirty = true;
+    m_orderDirty = true;
+}
+
+void InstanceBatch::setInstanceLevel(size_t index, int level) {
+    if (m_instanceLevels[index] == level) return;
+    m_levelCounts[m_instanceLevels[index]]--;
+    m_levelCounts[level]++;
+    m_instanceLevels[index] = (uint8_t)level;
+    m_dirty = true;
+    m_orderDirty = true;
+}
+
+void InstanceBatch::clearInstances() {
+    m_instances.clear();
+    m_instanceLevels.clear();
+    m_transforms = TransformSystem();
+    m_instanceTransforms.clear();
+    m_transformQueued.clear();
+    m_dirtyTransforms.clear();
+    std::fill(m_levelCounts.begin(), m_levelCounts.end(), 0);
+    m_dirty = true;
+    m_orderDirty = true;
+}
+
+const std::vector<InstanceData>& InstanceBatch::getOrderedInstances() {
+    if (m_levels.size() == 1) return m_instances;
+    if (!m_orderDirty) return m_ordered;
+
+    // 计数排序：各层级的实例连续存放，层级内保持插入顺序
+    std::vector<size_t> cursor(m_levels.size(), 0);
+    for (size_t level = 1; level < m_levels.size(); ++level) {
+        cursor[level] = cursor[level - 1] + m_levelCounts[level - 1];
+    }
+    m_ordered.resize(m_instances.size());
+    for (size_t i = 0; i < m_instances.size(); ++i) {
+        m_ordered[cursor[m_instanceLevels[i]]++] = m_instances[i];
+    }
+    m_orderDirty = false;
+    return m_ordered;
+}
+
+void InstanceBatch::uploadInstances(const std::vector<InstanceData>& instances) {
+    if (!m_dirty) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (instances.size() > m_gpuCapacity) {
+        // 容量不足时按两倍扩容，避免逐个增加实例时反复重新分配
+        m_gpuCapacity = instances.size() * 2;
+        glBufferData(GL_ARRAY_BUFFER, m_gpuCapacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (!instances.empty()) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_dirty = false;
+}
+
+DrawCommand InstanceBatch::getDrawCommand() const {
+    DrawCommand cmd = m_levels[0].mesh->getDrawCommand();
+    cmd.vao = m_levels[0].vao;
+    cmd.instanceCount = (GLsizei)m_instances.size();
+    return cmd;
+}
+
+uint32_t InstanceBatch::getDrawCallCount() const {
+    uint32_t count = 0;
+    for (size_t instances : m_levelCounts) count += instances > 0 ? 1 : 0;
+    return count;
+}
+
+uint32_t InstanceBatch::getTriangleCount() const {
+    uint32_t triangles = 0;
+    for (size_t level = 0; level < m_levels.size(); ++level) {
+        DrawCommand cmd = m_levels[level].mesh->getDrawCommand();
+        cmd.instanceCount = (GLsizei)m_levelCounts[level];
+        if (cmd.instanceCount > 0) triangles += cmd.getTriangleCount();
+    }
+    return triangles;
+}
+
+/**
+ * @brief 绘制所有实例：每个非空细节层级一次绘制调用
+ * @param shader 当前激活的着色器引用，会临时把 useInstancing 置为 true
+ */
+void InstanceBatch::draw(Shader& shader) {
+    if (m_instances.empty()) return;
+    TRACE_ZONE("InstanceBatch::draw");
+
+    updateTransforms();
+    const std::vector<InstanceData>& instances = getOrderedInstances();
+
+    // 有流式缓冲时把实例数据写进本帧区域；空间不足时退回静态实例缓冲
+    GLuint buffer = instanceVBO;
+    GLintptr baseOffset = 0;
+    GLintptr streamOffset = -1;
+    if (m_stream) {
+        streamOffset = m_stream->write(instances.data(), instances.size() * sizeof(InstanceData),
+                                       sizeof(InstanceData));
+    }
+    if (streamOffset >= 0) {
+        buffer = m_stream->getID();
+        baseOffset = streamOffset;
+    } else {
+        uploadInstances(instances);
+    }
+
+    shader.setInt("useInstancing", 1);
+    size_t first = 0;
+    for (size_t index = 0; index < m_levels.size(); ++index) {
+        size_t count = m_levelCounts[index];
+        if (count == 0) continue;
+
+        // 实例属性指向该层级实例组的起始位置；与上次相同（静态缓冲且分组未变）时不必重新设置
+        Level& level = m_levels[index];
+        GLintptr offset = baseOffset + (GLintptr)(first * sizeof(InstanceData));
+        glBindVertexArray(level.vao);
+        if (level.attributeBuffer != buffer || level.attributeOffset != offset) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            setInstanceAttributes(offset);
+            level.attributeBuffer = buffer;
+            level.attributeOffset = offset;
+        }
+
+        DrawCommand cmd = level.mesh->getDrawCommand();
+        cmd.vao = level.vao;
+        cmd.instanceCount = (GLsizei)count;
+        cmd.issue();
+        first += count;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    shader.setInt("useInstancing", 0);
+    glBindVertexArray(0);
+}
+
+// CubeBatch implementation
+CubeBatch::CubeBatch(float size) {
+    setupGeometry(MeshCache::getCube(), glm::vec3(size));
+}
+
+// SphereBatch implementation
+SphereBatch::SphereBatch(float radius, int sectors, int stacks) {
+    std::vector<std::shared_ptr<Mesh>> lodMeshes;
+    for (int level = 0; level < Sphere::LOD_COUNT; ++level) {
+        lodMeshes.push_back(Sphere::getLODMesh(sectors, stacks, level));
+    }
+    setupGeometry(lodMeshes, glm::vec3(radius));
+}
+
+uint32_t SphereBatch::updateLOD(const glm::vec3& cameraPosition, float pixelsPerUnit) {
+    updateTransforms();
+    uint32_t saved = 0;
+    GLsizei fullIndices = getLevelMesh(0)->getIndexCount();
+    for (size_t i = 0; i < getInstanceCount(); ++i) {
+        float screenRadius = Sphere::computeScreenRadius(getInstanceModel(i), cameraPosition, pixelsPerUnit);
+        int level = Sphere::selectLOD(getInstanceLevel(i), screenRadius);
+        setInstanceLevel(i, level);
+        saved += (uint32_t)(fullIndices - getLevelMesh(level)->getIndexCount()) / 3;
+    }
+    return saved;
+}
@@ -0,0 +1,200 @@
+#include <shape/mesh.hpp>
+#include <GL/glew.h>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+CpuResidency s_defaultResidency = CpuResidency::DISCARD;
+}
+
+// Mesh implementation
+Mesh::Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+           const VertexFormat& format, GLenum usage, CpuResidency residency)
+    : m_format(format), m_vertexCount((GLsizei)(vertices.size() / 6)), m_indexCount((GLsizei)indices.size()),
+      m_residency(residency) {
+
+    // 生成并绑定VAO
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    // 生成并填充VBO
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    std::vector<uint8_t> encoded = m_format.encode(vertices);
+    glBufferData(GL_ARRAY_BUFFER, encoded.size(), encoded.data(), usage);
+
+    // 生成并填充EBO；顶点数允许时使用 16 位索引，索引带宽减半
+    if (!indices.empty()) {
+        glGenBuffers(1, &EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        if (m_vertexCount <= 65536) {
+            std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(),
+                         GL_STATIC_DRAW);
+            m_indexType = GL_UNSIGNED_SHORT;
+        } else {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
+                         GL_STATIC_DRAW);
+            m_indexType = GL_UNSIGNED_INT;
+        }
+    }
+
+    setupVertexAttributes();
+
+    // 解绑VAO
+    glBindVertexArray(0);
+
+    if (m_residency == CpuResidency::RETAIN) {
+        m_cpuVertices = vertices;
+        m_cpuIndices = indices;
+    }
+}
+
+CpuResidency Mesh::getDefaultResidency() {
+    return s_defaultResidency;
+}
+
+void Mesh::setDefaultResidency(CpuResidency residency) {
+    s_defaultResidency = residency;
+}
+
+Mesh::~Mesh() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    if (EBO) glDeleteBuffers(1, &EBO);
+}
+
+void Mesh::setupVertexAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (EBO) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    // 设置顶点属性指针（位置+法线）；颜色不在顶点流中
+    m_format.setupAttributes();
+}
+
+DrawCommand Mesh::getDrawCommand() const {
+    if (EBO) {
+        return DrawCommand{ VAO, GL_TRIANGLES, m_indexCount, m_indexType };
+    }
+    return DrawCommand{ VAO, GL_TRIANGLES, m_vertexCount, 0 };
+}
+
+void Mesh::updateVertices(size_t first, const std::vector<float>& vertices) {
+    if (vertices.empty()) return;
+    if (first + vertices.size() / 6 > (size_t)m_vertexCount) {
+        throw std::out_of_range("Mesh::updateVertices: vertex range out of bounds");
+    }
+    if (m_residency == CpuResidency::RETAIN) {
+        std::copy(vertices.begin(), vertices.end(), m_cpuVertices.begin() + first * 6);
+    }
+
+    std::vector<uint8_t> encoded = m_format.encode(vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, first * m_format.getStride(), encoded.size(), encoded.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// MeshCache implementation
+MeshOptimizeStats MeshCache::generate(const MeshKey& key, std::vector<float>& vertices,
+                                      std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+    switch (key.type) {
+        case PrimitiveType::CUBE:
+            vertices = Cube::generateVertices(1.0f);
+            break;
+        case PrimitiveType::SPHERE:
+            Sphere::generateMesh(1.0f, key.sectors, key.stacks, vertices, indices);
+            break;
+    }
+
+    // 去重（立方体 36 -> 24 个顶点）、顶点缓存与过绘制优化
+    return MeshOptimizer::optimize(vertices, indices, 6);
+}
+
+std::shared_ptr<Mesh> MeshCache::get(const MeshKey& key) {
+    auto it = s_meshes.find(key);
+    if (it != s_meshes.end()) {
+        if (auto mesh = it->second.lock()) return mesh;
+    }
+
+    // 生成单位尺寸网格并上传
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    MeshOptimizeStats stats = generate(key, vertices, indices);
+
+    // 单位网格的坐标都在 [-1, 1] 内，可以使用 SNORM16
+    auto mesh = std::make_shared<Mesh>(vertices, indices, key.format);
+    mesh->setOptimizeStats(stats);
+    s_meshes[key] = mesh;
+    return mesh;
+}
+
+std::shared_ptr<Mesh> MeshCache::createUnique(const MeshKey& key) {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    MeshOptimizeStats stats = generate(key, vertices, indices);
+
+    // 修改后的顶点范围未知，位置改用 FLOAT32（法线仍可打包）
+    VertexFormat format = key.format.forRange(std::numeric_limits<float>::max());
+    auto mesh = std::make_shared<Mesh>(vertices, indices, format, GL_DYNAMIC_DRAW, CpuResidency::RETAIN);
+    mesh->setOptimizeStats(stats);
+    return mesh;
+}
+
+std::shared_ptr<Mesh> MeshCache::getCube() {
+    return get(MeshKey{ PrimitiveType::CUBE, 0, 0 });
+}
+
+std::shared_ptr<Mesh> MeshCache::getSphere(int sectors, int stacks) {
+    return get(MeshKey{ PrimitiveType::SPHERE, sectors, stacks });
+}
+
+size_t MeshCache::liveCount() {
+    size_t count = 0;
+    for (auto it = s_meshes.begin(); it != s_meshes.end();) {
+        if (it->second.expired()) {
+            it = s_meshes.erase(it);
+        } else {
+            ++count;
+            ++it;
+        }
+    }
+    return count;
+}
+
+size_t MeshCache::getGpuBytes() {
+    size_t bytes = 0;
+    for (const auto& entry : s_meshes) {
+        if (auto mesh = entry.second.lock()) bytes += mesh->getGpuBytes();
+    }
+    return bytes;
+}
+
+size_t MeshCache::getCpuBytes() {
+    size_t bytes = 0;
+    for (const auto& entry : s_meshes) {
+        if (auto mesh = entry.second.lock()) bytes += mesh->getCpuBytes();
+    }
+    return bytes;
+}
+
+void MeshCache::printStats(std::ostream& out) {
+    static const char* names[] = { "cube", "sphere" };
+    for (const auto& entry : s_meshes) {
+        auto mesh = entry.second.lock();
+        if (!mesh) continue;
+
+        const MeshKey& key = entry.first;
+        const MeshOptimizeStats& stats = mesh->getOptimizeStats();
+        out << names[static_cast<int>(key.type)];
+        if (key.type == PrimitiveType::SPHERE) out << " " << key.sectors << "x" << key.stacks;
+        out << ": vertices " << stats.vertexCountBefore << " -> " << stats.vertexCountAfter
+            << " (" << mesh->getVertexBytes() << " bytes), triangles " << stats.triangleCount
+            << ", " << (mesh->getIndexType() == GL_UNSIGNED_SHORT ? 16 : 32) << "-bit indices"
+            << ", ACMR " << std::fixed << std::setprecision(3) << stats.acmrBefore << " -> " << stats.acmrAfter
+            << std::defaultfloat << std::endl;
+    }
+}
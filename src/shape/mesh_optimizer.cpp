@@ -0,0 +1,353 @@
+#include <shape/mesh_optimizer.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Forsyth 评分参数（"Linear-Speed Vertex Cache Optimisation"）
+constexpr int SCORE_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+float vertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // 刚用过的三个顶点得分固定，避免总是挑选相邻三角形导致条带过长
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scaler = 1.0f / (SCORE_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+    // 剩余三角形少的顶点优先处理完，避免之后再次载入
+    return score + VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+}
+
+/**
+ * @brief FIFO 缓存模拟器
+ */
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, int size) : m_timestamps(vertexCount, 0), m_size(size) {}
+
+    /**
+     * @brief 访问顶点，返回是否未命中
+     */
+    bool access(uint32_t vertex) {
+        // 时间戳距今超过缓存大小即已被挤出
+        if (m_time - m_timestamps[vertex] >= (unsigned)m_size || m_timestamps[vertex] == 0) {
+            m_timestamps[vertex] = ++m_time;
+            return true;
+        }
+        return false;
+    }
+
+    void reset() { m_time += m_size + 1; }
+
+private:
+    std::vector<unsigned> m_timestamps;
+    unsigned m_time = 0;
+    int m_size;
+};
+
+} // namespace
+
+MeshOptimizeStats MeshOptimizer::optimize(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride) {
+    MeshOptimizeStats stats;
+    stats.vertexCountBefore = vertices.size() / stride;
+
+    if (indices.empty()) {
+        indices.resize(stats.vertexCountBefore);
+        for (size_t i = 0; i < indices.size(); ++i) indices[i] = (uint32_t)i;
+    }
+    stats.triangleCount = indices.size() / 3;
+    stats.acmrBefore = computeACMR(indices, stats.vertexCountBefore);
+
+    size_t vertexCount = deduplicateVertices(vertices, indices, stride);
+
+    // 小网格上贪心算法不一定胜过生成顺序，每一步都只在不变差时保留
+    std::vector<uint32_t> best = indices;
+    float bestACMR = computeACMR(indices, vertexCount);
+
+    optimizeVertexCache(indices, vertexCount);
+    float cacheACMR = computeACMR(indices, vertexCount);
+    if (cacheACMR <= bestACMR) {
+        best = indices;
+        bestACMR = cacheACMR;
+    }
+
+    indices = best;
+    optimizeOverdraw(indices, vertices, stride);
+    if (computeACMR(indices, vertexCount) > bestACMR * 1.05f) indices = best;
+
+    optimizeVertexFetch(vertices, indices, stride);
+
+    stats.vertexCountAfter = vertices.size() / stride;
+    stats.acmrAfter = computeACMR(indices, stats.vertexCountAfter);
+    return stats;
+}
+
+size_t MeshOptimizer::deduplicateVertices(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride) {
+    const size_t vertexCount = vertices.size() / stride;
+    const size_t vertexBytes = stride * sizeof(float);
+
+    // 按顶点数据的字节哈希；桶内逐字节比较
+    auto hashVertex = [&](uint32_t v) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertices[v * stride]);
+        size_t h = 2166136261u;
+        for (size_t i = 0; i < vertexBytes; ++i) h = (h ^ bytes[i]) * 16777619u;
+        return h;
+    };
+    auto equalVertex = [&](uint32_t a, uint32_t b) {
+        return std::memcmp(&vertices[a * stride], &vertices[b * stride], vertexBytes) == 0;
+    };
+    std::unordered_map<uint32_t, uint32_t, decltype(hashVertex), decltype(equalVertex)>
+        unique(vertexCount, hashVertex, equalVertex);
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<float> result;
+    result.reserve(vertices.size());
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        auto it = unique.find(v);
+        if (it != unique.end()) {
+            remap[v] = it->second;
+            continue;
+        }
+        uint32_t newIndex = (uint32_t)(result.size() / stride);
+        unique.emplace(v, newIndex);
+        remap[v] = newIndex;
+        result.insert(result.end(), vertices.begin() + v * stride, vertices.begin() + (v + 1) * stride);
+    }
+
+    for (auto& index : indices) index = remap[index];
+    // 哈希表持有对旧顶点数组的引用，替换前先清空
+    unique.clear();
+    vertices.swap(result);
+    return vertices.size() / stride;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // 顶点 -> 相邻三角形表
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (uint32_t index : indices) adjacencyOffset[index + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyOffset[v + 1] += adjacencyOffset[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<int> remaining(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) remaining[v] = (int)(adjacencyOffset[v + 1] - adjacencyOffset[v]);
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScores[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+    }
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(SCORE_CACHE_SIZE + 3);
+    nextCache.reserve(SCORE_CACHE_SIZE + 3);
+    size_t scanCursor = 0;
+
+    int bestTriangle = -1;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // 缓存中没有可用的三角形：从头扫描未输出三角形中得分最高的（按游标推进，保持线性）
+            float bestScore = -1e30f;
+            for (size_t t = scanCursor; t < triangleCount; ++t) {
+                if (emitted[t]) {
+                    if (t == scanCursor) ++scanCursor;
+                    continue;
+                }
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (int)t;
+                }
+            }
+        }
+
+        const uint32_t* tri = &indices[bestTriangle * 3];
+        output.insert(output.end(), tri, tri + 3);
+        emitted[bestTriangle] = true;
+
+        // 从相邻表中移除该三角形
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            uint32_t* begin = &adjacency[adjacencyOffset[v]];
+            uint32_t* end = begin + remaining[v];
+            *std::find(begin, end, (uint32_t)bestTriangle) = *(end - 1);
+            remaining[v]--;
+        }
+
+        // 新三角形的顶点放到缓存最前面
+        nextCache.assign(tri, tri + 3);
+        for (uint32_t v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) nextCache.push_back(v);
+        }
+        std::swap(cache, nextCache);
+
+        // 更新缓存内（及刚被挤出）顶点的得分，并顺带找下一个最佳三角形
+        for (size_t i = 0; i < cache.size(); ++i) {
+            cachePosition[cache[i]] = i < (size_t)SCORE_CACHE_SIZE ? (int)i : -1;
+        }
+        bestTriangle = -1;
+        float bestScore = -1e30f;
+        for (uint32_t v : cache) {
+            float newScore = vertexScore(cachePosition[v], remaining[v]);
+            float delta = newScore - vertexScores[v];
+            vertexScores[v] = newScore;
+            for (uint32_t a = 0; a < (uint32_t)remaining[v]; ++a) {
+                uint32_t t = adjacency[adjacencyOffset[v] + a];
+                triangleScores[t] += delta;
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (int)t;
+                }
+            }
+        }
+        if (cache.size() > (size_t)SCORE_CACHE_SIZE) cache.resize(SCORE_CACHE_SIZE);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float>& vertices, int stride,
+                                     float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size() / stride;
+    if (triangleCount < 2) return;
+
+    const float globalACMR = computeACMR(indices, vertexCount);
+
+    // 切分簇：三个顶点全部未命中处为硬边界；簇内 ACMR 已不差于全局水平时允许提前切分（软边界）
+    std::vector<size_t> clusterStarts;
+    FifoCache cache(vertexCount, CACHE_SIZE);
+    size_t clusterStart = 0, clusterMisses = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) misses += cache.access(indices[t * 3 + k]);
+
+        bool hardBoundary = misses == 3;
+        size_t clusterTriangles = t - clusterStart;
+        bool softBoundary = clusterTriangles >= 8 &&
+                            (float)clusterMisses / clusterTriangles <= globalACMR * threshold && misses > 0;
+        if (t == 0 || hardBoundary || softBoundary) {
+            clusterStarts.push_back(t);
+            clusterStart = t;
+            clusterMisses = 0;
+            if (softBoundary && !hardBoundary) {
+                // 软边界处重置缓存，按簇独立绘制时的真实代价统计
+                cache.reset();
+                misses = 0;
+                for (int k = 0; k < 3; ++k) misses += cache.access(indices[t * 3 + k]);
+            }
+        }
+        clusterMisses += misses;
+    }
+    if (clusterStarts.size() < 2) return;
+    clusterStarts.push_back(triangleCount);
+
+    auto position = [&](uint32_t v) {
+        const float* p = &vertices[v * stride];
+        return std::array<float, 3>{ p[0], p[1], p[2] };
+    };
+
+    // 网格中心（按面积加权）
+    float meshCenter[3] = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    std::vector<float> triangleData(triangleCount * 7);  // 面积加权的法线(3) + 重心(3) + 面积
+    for (size_t t = 0; t < triangleCount; ++t) {
+        auto a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), c = position(indices[t * 3 + 2]);
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        float area = 0.5f * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float* d = &triangleData[t * 7];
+        for (int k = 0; k < 3; ++k) {
+            d[k] = n[k];
+            d[3 + k] = (a[k] + b[k] + c[k]) / 3.0f;
+            meshCenter[k] += d[3 + k] * area;
+        }
+        d[6] = area;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) {
+        for (float& c : meshCenter) c /= meshArea;
+    }
+
+    // 簇的排序键：簇重心相对网格中心在簇平均法线上的投影，越大越靠外、越可能遮挡其它簇
+    const size_t clusterCount = clusterStarts.size() - 1;
+    std::vector<std::pair<float, size_t>> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float normal[3] = { 0.0f, 0.0f, 0.0f }, center[3] = { 0.0f, 0.0f, 0.0f }, area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const float* d = &triangleData[t * 7];
+            for (int k = 0; k < 3; ++k) {
+                normal[k] += d[k];
+                center[k] += d[3 + k] * d[6];
+            }
+            area += d[6];
+        }
+        float key = 0.0f;
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (area > 0.0f && length > 0.0f) {
+            for (int k = 0; k < 3; ++k) key += (center[k] / area - meshCenter[k]) * normal[k] / length;
+        }
+        order[c] = { -key, c };
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto& entry : order) {
+        size_t c = entry.second;
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices, int stride) {
+    const size_t vertexCount = vertices.size() / stride;
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    std::vector<float> result;
+    result.reserve(vertices.size());
+
+    for (auto& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = (uint32_t)(result.size() / stride);
+            result.insert(result.end(), vertices.begin() + index * stride, vertices.begin() + (index + 1) * stride);
+        }
+        index = remap[index];
+    }
+    // 未被引用的顶点直接丢弃
+    vertices.swap(result);
+}
+
+float MeshOptimizer::computeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize) {
+    if (indices.size() < 3) return 0.0f;
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (uint32_t index : indices) misses += cache.access(index);
+    return (float)misses / (float)(indices.size() / 3);
+}
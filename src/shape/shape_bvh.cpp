@@ -0,0 +1,51 @@
+#include <shape_bvh.hpp>
+
+ShapeBVH::~ShapeBVH() {
+    for (auto& entry : m_proxies) {
+        const_cast<Shape*>(entry.first)->setObserver(nullptr);
+    }
+}
+
+void ShapeBVH::add(ColoredShape* shape) {
+    if (m_proxies.count(shape)) return;
+    int proxy = m_tree.insert(shape->getWorldBounds(), shape);
+    m_proxies.emplace(shape, proxy);
+    shape->setObserver(this);
+}
+
+void ShapeBVH::remove(ColoredShape* shape) {
+    auto it = m_proxies.find(shape);
+    if (it == m_proxies.end()) return;
+    m_tree.remove(it->second);
+    m_proxies.erase(it);
+    shape->setObserver(nullptr);
+}
+
+void ShapeBVH::onBoundsChanged(Shape& shape) {
+    auto it = m_proxies.find(&shape);
+    if (it == m_proxies.end()) return;
+    m_tree.update(it->second, shape.getWorldBounds());
+}
+
+void ShapeBVH::onShapeDestroyed(Shape& shape) {
+    auto it = m_proxies.find(&shape);
+    if (it == m_proxies.end()) return;
+    m_tree.remove(it->second);
+    m_proxies.erase(it);
+}
+
+bool ShapeBVH::maintain(float threshold) {
+    return m_tree.rebuildIfDegraded(threshold);
+}
+
+void ShapeBVH::cull(const Frustum& frustum, std::vector<ColoredShape*>& out) const {
+    m_queryResult.clear();
+    m_tree.queryFrustum(frustum, m_queryResult);
+    for (void* data : m_queryResult) {
+        out.push_back(static_cast<ColoredShape*>(data));
+    }
+}
+
+ColoredShape* ShapeBVH::raycast(const Ray& ray, float maxDistance, float* hitDistance) const {
+    return static_cast<ColoredShape*>(m_tree.raycast(ray, maxDistance, hitDistance));
+}
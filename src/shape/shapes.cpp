@@ -1,47 +1,359 @@
 #include <shapes.hpp>
+#include <mesh.hpp>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vertex_format.hpp>
+#include <basic/trace.hpp>
+
+namespace {
+
+/**
+ * @brief 按默认顶点格式编码图元顶点，上传到新建的 VAO/VBO
+ * @param vertices 交错的顶点数据：位置(3) + 法线(3)
+ * @return 实际使用的顶点格式
+ */
+VertexFormat uploadPrimitive(GLuint& vao, GLuint& vbo, const std::vector<float>& vertices) {
+    float maxAbs = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (i % 6 < 3) maxAbs = std::max(maxAbs, std::abs(vertices[i]));
+    }
+    VertexFormat format = VertexFormat::getDefault().forRange(maxAbs);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    std::vector<uint8_t> encoded = format.encode(vertices);
+    glBufferData(GL_ARRAY_BUFFER, encoded.size(), encoded.data(), GL_STATIC_DRAW);
+    format.setupAttributes();
+
+    glBindVertexArray(0);
+    return format;
+}
+
+/**
+ * @brief 为四边形的 VAO 创建索引缓冲：两个三角形（扇形 0,1,2 / 0,2,3），16 位索引
+ *
+ * 核心模式下没有 GL_QUADS。
+ */
+GLuint uploadQuadIndices(GLuint vao) {
+    static const uint16_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+    GLuint ebo;
+    glBindVertexArray(vao);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    return ebo;
+}
+
+/**
+ * @brief 多边形法线（Newell 方法，顶点按逆时针为正面）；退化时返回 +Z
+ */
+glm::vec3 polygonNormal(const glm::vec3* vertices, int count) {
+    glm::vec3 normal(0.0f);
+    for (int i = 0; i < count; ++i) {
+        const glm::vec3& a = vertices[i];
+        const glm::vec3& b = vertices[(i + 1) % count];
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+    }
+    float length = glm::length(normal);
+    return length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+/**
+ * @brief 组装交错顶点数据，所有顶点共用一个法线
+ */
+std::vector<float> interleave(const glm::vec3* positions, int count, const glm::vec3& normal) {
+    std::vector<float> data;
+    data.reserve(count * 6);
+    for (int i = 0; i < count; ++i) {
+        data.insert(data.end(), { positions[i].x, positions[i].y, positions[i].z, normal.x, normal.y, normal.z });
+    }
+    return data;
+}
+
+/**
+ * @brief 更新图元的一段顶点（所有顶点共用一个法线）
+ *
+ * 只用 glBufferSubData 上传 [first, first + dirtyCount)；新位置超出当前格式的表示范围时
+ * 改用更宽的格式，整体重新上传并重设属性指针。
+ * @param format 当前顶点格式（可能被放宽）
+ * @param positions 全部顶点位置
+ * @param count 顶点总数
+ */
+void updatePrimitive(GLuint vao, GLuint vbo, VertexFormat& format, const glm::vec3* positions, int count,
+                     const glm::vec3& normal, int first, int dirtyCount) {
+    float maxAbs = 0.0f;
+    for (int i = first; i < first + dirtyCount; ++i) {
+        maxAbs = std::max({ maxAbs, std::abs(positions[i].x), std::abs(positions[i].y), std::abs(positions[i].z) });
+    }
+
+    VertexFormat required = format.forRange(maxAbs);
+    if (!(required == format)) {
+        format = required;
+        std::vector<uint8_t> encoded = format.encode(interleave(positions, count, normal));
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, encoded.size(), encoded.data(), GL_DYNAMIC_DRAW);
+        format.setupAttributes();
+        glBindVertexArray(0);
+        return;
+    }
+
+    std::vector<uint8_t> encoded = format.encode(interleave(positions + first, dirtyCount, normal));
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, first * format.getStride(), encoded.size(), encoded.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * @brief 顶点的包围盒
+ */
+AABB boundsOf(const glm::vec3* positions, int count) {
+    AABB bounds;
+    for (int i = 0; i < count; ++i) bounds.expand(positions[i]);
+    return bounds;
+}
+
+} // namespace
+
+// DrawCommand implementation
+void DrawCommand::issue() const {
+    if (instanceCount > 0) {
+        if (indexType == 0) {
+            glDrawArraysInstanced(mode, 0, count, instanceCount);
+        } else {
+            glDrawElementsInstanced(mode, count, indexType, 0, instanceCount);
+        }
+    } else if (indexType == 0) {
+        glDrawArrays(mode, 0, count);
+    } else {
+        glDrawElements(mode, count, indexType, 0);
+    }
+}
+
+uint32_t DrawCommand::getTriangleCount() const {
+    if (mode != GL_TRIANGLES) return 0;
+    return (uint32_t)(count / 3) * (uint32_t)(instanceCount > 0 ? instanceCount : 1);
+}
 
 // Shape implementation
 /**
  * @brief 基础构造函数，初始化变换为单位变换
  */
-Shape::Shape() : m_position(0.0f, 0.0f, 0.0f), m_rotation(0.0f, 0.0f, 0.0f), m_scale(1.0f, 1.0f, 1.0f) {
+Shape::Shape() : m_position(0.0f, 0.0f, 0.0f), m_rotation(0.0f, 0.0f, 0.0f), m_scale(1.0f, 1.0f, 1.0f), m_meshScale(1.0f, 1.0f, 1.0f) {
+}
+
+Shape::~Shape() {
+    if (m_parent) {
+        auto& siblings = m_parent->m_children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    }
+    // 子节点脱离后以自身变换作为世界变换
+    for (Shape* child : m_children) {
+        child->m_parent = nullptr;
+        child->invalidateTransform();
+    }
+    if (m_boundsQueued) {
+        *std::find(s_pendingBounds.begin(), s_pendingBounds.end(), this) = nullptr;
+    }
+    if (m_observer) m_observer->onShapeDestroyed(*this);
 }
 
 void Shape::setPosition(const glm::vec3& position) {
     m_position = position;
+    m_localDirty = true;
+    invalidateTransform();
 }
 
 void Shape::move(const glm::vec3& offset) {
     m_position += offset;
+    m_localDirty = true;
+    invalidateTransform();
 }
 
 void Shape::setRotation(const glm::vec3& rotation) {
     m_rotation = rotation;
+    m_localDirty = true;
+    invalidateTransform();
 }
 
 void Shape::setScale(const glm::vec3& scale) {
     m_scale = scale;
+    m_localDirty = true;
+    invalidateTransform();
+}
+
+void Shape::setMeshScale(const glm::vec3& meshScale) {
+    m_meshScale = meshScale;
+    invalidateTransform();
+}
+
+bool Shape::setParent(Shape* parent) {
+    for (Shape* ancestor = parent; ancestor; ancestor = ancestor->m_parent) {
+        if (ancestor == this) return false;
+    }
+
+    if (m_parent) {
+        auto& siblings = m_parent->m_children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    }
+    m_parent = parent;
+    if (m_parent) m_parent->m_children.push_back(this);
+    invalidateTransform();
+    return true;
+}
+
+std::vector<Shape*> Shape::s_pendingBounds;
+
+void Shape::invalidateTransform() {
+    // 只设置标记；矩阵在读取时、包围体在读取或 flushTransforms() 时才计算
+    m_worldDirty = true;
+    invalidateBounds();
+    for (Shape* child : m_children) {
+        child->invalidateTransform();
+    }
+}
+
+void Shape::invalidateBounds() {
+    m_boundsDirty = true;
+    if (!m_boundsQueued) {
+        m_boundsQueued = true;
+        s_pendingBounds.push_back(this);
+    }
+}
+
+void Shape::flushTransforms() {
+    TRACE_ZONE("Shape::flushTransforms");
+    // 观察者回调中可能再次修改变换，新加入的形状留到下一次处理
+    size_t count = s_pendingBounds.size();
+    for (size_t i = 0; i < count; ++i) {
+        Shape* shape = s_pendingBounds[i];
+        if (!shape) continue;       // 排队后已析构
+        shape->m_boundsQueued = false;
+        if (shape->m_observer) shape->m_observer->onBoundsChanged(*shape);
+    }
+    s_pendingBounds.erase(s_pendingBounds.begin(), s_pendingBounds.begin() + count);
+}
+
+void Shape::setLocalBounds(const AABB& bounds) {
+    m_localBounds = bounds;
+    invalidateBounds();
+}
+
+const AABB& Shape::getWorldBounds() const {
+    if (m_boundsDirty) updateWorldBounds();
+    return m_worldBounds;
+}
+
+const BoundingSphere& Shape::getWorldSphere() const {
+    if (m_boundsDirty) updateWorldBounds();
+    return m_worldSphere;
 }
 
-glm::mat4 Shape::getModelMatrix() const {
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, m_position);
-    model = glm::rotate(model, glm::radians(m_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(m_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(m_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::scale(model, m_scale);
-    return model;
+void Shape::updateWorldBounds() const {
+    m_worldBounds = transformAABB(m_localBounds, getModelMatrix());
+    m_worldSphere = sphereFromAABB(m_worldBounds);
+    m_boundsDirty = false;
+}
+
+/**
+ * @brief 单独绘制该形状：上传 model，绑定 VAO，绘制后解绑
+ * @param shader 当前激活的着色器引用，需定义 model uniform
+ */
+void Shape::draw(Shader& shader) {
+    TRACE_ZONE("Shape::draw");
+    shader.setMat4("model", getModelMatrix());
+    shader.setMat3("normalMatrix", getNormalMatrix());
+
+    DrawCommand cmd = getDrawCommand();
+    glBindVertexArray(cmd.vao);
+    cmd.issue();
+    glBindVertexArray(0);
+}
+
+ShapeMemoryUsage Shape::getMemoryUsage() const {
+    ShapeMemoryUsage usage;
+    usage.cpuBytes = sizeof(Shape) + m_children.capacity() * sizeof(Shape*);
+    return usage;
+}
+
+const glm::mat4& Shape::getModelMatrix() const {
+    if (m_worldDirty) updateMatrices();
+    return m_modelMatrix;
+}
+
+const glm::mat3& Shape::getNormalMatrix() const {
+    if (m_worldDirty) updateMatrices();
+    return m_normalMatrix;
+}
+
+const glm::mat4& Shape::getWorldTransform() const {
+    if (m_worldDirty) updateMatrices();
+    return m_worldMatrix;
+}
+
+void Shape::updateMatrices() const {
+    if (m_localDirty) {
+        glm::mat4 local = glm::mat4(1.0f);
+        local = glm::translate(local, m_position);
+        local = glm::rotate(local, glm::radians(m_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        local = glm::rotate(local, glm::radians(m_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        local = glm::rotate(local, glm::radians(m_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        m_localMatrix = glm::scale(local, m_scale);
+        m_localDirty = false;
+    }
+
+    m_worldMatrix = m_parent ? m_parent->getWorldTransform() * m_localMatrix : m_localMatrix;
+
+    // 网格固有尺寸只作用于自身，不传给子节点
+    m_modelMatrix = m_worldMatrix;
+    m_modelMatrix[0] *= m_meshScale.x;
+    m_modelMatrix[1] *= m_meshScale.y;
+    m_modelMatrix[2] *= m_meshScale.z;
+    m_normalMatrix = computeNormalMatrix(m_modelMatrix);
+    m_worldDirty = false;
+}
+
+glm::mat3 Shape::computeNormalMatrix(const glm::mat4& model) {
+    glm::vec3 c0(model[0]), c1(model[1]), c2(model[2]);
+
+    // 各列等长且两两正交（旋转 * 均匀缩放）：逆转置与原矩阵只差一个正的缩放系数
+    float l0 = glm::dot(c0, c0), l1 = glm::dot(c1, c1), l2 = glm::dot(c2, c2);
+    float tolerance = 1e-5f * std::max({ l0, l1, l2 });
+    if (std::abs(l0 - l1) <= tolerance && std::abs(l0 - l2) <= tolerance &&
+        std::abs(glm::dot(c0, c1)) <= tolerance && std::abs(glm::dot(c0, c2)) <= tolerance &&
+        std::abs(glm::dot(c1, c2)) <= tolerance) {
+        return glm::mat3(c0, c1, c2);
+    }
+
+    // 逆转置 = 余子式矩阵 / 行列式
+    glm::vec3 r0 = glm::cross(c1, c2), r1 = glm::cross(c2, c0), r2 = glm::cross(c0, c1);
+    float det = glm::dot(c0, r0);
+    if (std::abs(det) < 1e-20f) return glm::mat3(c0, c1, c2);
+    float invDet = 1.0f / det;
+    return glm::mat3(r0 * invDet, r1 * invDet, r2 * invDet);
 }
 
 // ColoredShape implementation
 ColoredShape::ColoredShape(const glm::vec3& color) : m_color(color) {
 }
 
+void ColoredShape::draw(Shader& shader) {
+    glVertexAttrib3fv(2, &m_color[0]);
+    Shape::draw(shader);
+}
+
 void ColoredShape::setColor(const glm::vec3& color) {
     m_color = color;
 }
@@ -52,46 +364,24 @@ glm::vec3 ColoredShape::getColor() const {
 
 // Point implementation
 Point::Point(float x, float y, float z, const glm::vec3& color) : ColoredShape(color), position(x, y, z) {
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    // 点没有几何法线，取 +Z；颜色由 ColoredShape 作为通用顶点属性设置
+    m_format = uploadPrimitive(VAO, VBO, interleave(&position, 1, glm::vec3(0.0f, 0.0f, 1.0f)));
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float pointData[6] = {
-        position.x, position.y, position.z,
-        m_color.r, m_color.g, m_color.b
-    };
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(pointData), pointData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    setLocalBounds(AABB(position, position));
 }
 
 /**
- * @brief 绘制单个点
- * @param shader 当前激活的着色器引用。函数会使用 shader.setMat4("model", ...) 和 shader.setVec3("color", ...)
- *               因此传入的着色器需要定义对应 uniform（model, color）。
+ * @brief 单个点的绘制命令
  */
-void Point::draw(Shader& shader) {
-    // 上传 model
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
+DrawCommand Point::getDrawCommand() const {
+    return DrawCommand{ VAO, GL_POINTS, 1, 0 };
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_POINTS, 0, 1);
-    glBindVertexArray(0);
+ShapeMemoryUsage Point::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Point) - sizeof(Shape);
+    usage.gpuBytes += m_format.getStride();
+    return usage;
 }
 
 Point::~Point() {
@@ -111,46 +401,40 @@ Line::Line(float startX, float startY, float startZ,
            const glm::vec3& color)
     : ColoredShape(color), startPoint(startX, startY, startZ), endPoint(endX, endY, endZ) {
     
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    // 线段没有几何法线，取 +Z；颜色由 ColoredShape 作为通用顶点属性设置
+    glm::vec3 endpoints[2] = { startPoint, endPoint };
+    m_format = uploadPrimitive(VAO, VBO, interleave(endpoints, 2, glm::vec3(0.0f, 0.0f, 1.0f)));
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float lineData[12] = {
-        startPoint.x, startPoint.y, startPoint.z,
-        m_color.r, m_color.g, m_color.b,
-        endPoint.x, endPoint.y, endPoint.z,
-        m_color.r, m_color.g, m_color.b
-    };
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(lineData), lineData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    setLocalBounds(AABB(glm::min(startPoint, endPoint), glm::max(startPoint, endPoint)));
+}
+
+void Line::setEndpoints(const glm::vec3& start, const glm::vec3& end) {
+    bool startChanged = start != startPoint;
+    bool endChanged = end != endPoint;
+    if (!startChanged && !endChanged) return;
+
+    startPoint = start;
+    endPoint = end;
+    glm::vec3 endpoints[2] = { startPoint, endPoint };
+    int first = startChanged ? 0 : 1;
+    int dirtyCount = (startChanged && endChanged) ? 2 : 1;
+    updatePrimitive(VAO, VBO, m_format, endpoints, 2, glm::vec3(0.0f, 0.0f, 1.0f), first, dirtyCount);
+
+    setLocalBounds(AABB(glm::min(startPoint, endPoint), glm::max(startPoint, endPoint)));
 }
 
 /**
- * @brief 绘制线段
- * @param shader 着色器引用，会上传 model 矩阵与 color
+ * @brief 线段的绘制命令
  */
-void Line::draw(Shader& shader) {
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
+DrawCommand Line::getDrawCommand() const {
+    return DrawCommand{ VAO, GL_LINES, 2, 0 };
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_LINES, 0, 2);
-    glBindVertexArray(0);
+ShapeMemoryUsage Line::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Line) - sizeof(Shape);
+    usage.gpuBytes += 2 * m_format.getStride();
+    return usage;
 }
 
 Line::~Line() {
@@ -168,36 +452,10 @@ Triangle::Triangle(float x1, float y1, float z1,
     vertices[1] = glm::vec3(x2, y2, z2);
     vertices[2] = glm::vec3(x3, y3, z3);
     
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    m_normal = polygonNormal(vertices, 3);
+    m_format = uploadPrimitive(VAO, VBO, interleave(vertices, 3, m_normal));
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float triangleData[18];
-    for (int i = 0; i < 3; i++) {
-        triangleData[i*6]     = vertices[i].x;
-        triangleData[i*6 + 1] = vertices[i].y;
-        triangleData[i*6 + 2] = vertices[i].z;
-        triangleData[i*6 + 3] = m_color.r;
-        triangleData[i*6 + 4] = m_color.g;
-        triangleData[i*6 + 5] = m_color.b;
-    }
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(triangleData), triangleData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    setLocalBounds(boundsOf(vertices, 3));
 }
 
 /**
@@ -213,49 +471,52 @@ Triangle::Triangle(
     this->vertices[1] = p2.getPosition();
     this->vertices[2] = p3.getPosition();
 
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    m_normal = polygonNormal(vertices, 3);
+    m_format = uploadPrimitive(VAO, VBO, interleave(vertices, 3, m_normal));
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float triangleData[18];
-    for (int i = 0; i < 3; i++) {
-        triangleData[i*6]     = vertices[i].x;
-        triangleData[i*6 + 1] = vertices[i].y;
-        triangleData[i*6 + 2] = vertices[i].z;
-        triangleData[i*6 + 3] = m_color.r;
-        triangleData[i*6 + 4] = m_color.g;
-        triangleData[i*6 + 5] = m_color.b;
+    setLocalBounds(boundsOf(vertices, 3));
+}
+
+void Triangle::setVertices(int first, const glm::vec3* positions, int count) {
+    if (first < 0 || count < 0 || first + count > 3) {
+        throw std::out_of_range("Triangle::setVertices: vertex range out of bounds");
     }
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(triangleData), triangleData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    std::copy(positions, positions + count, vertices + first);
+
+    // 法线不变时（例如在平面内移动顶点）只上传改动的顶点，否则三个顶点的法线都要更新
+    glm::vec3 normal = polygonNormal(vertices, 3);
+    if (normal != m_normal) {
+        m_normal = normal;
+        first = 0;
+        count = 3;
+    }
+    updatePrimitive(VAO, VBO, m_format, vertices, 3, m_normal, first, count);
+
+    setLocalBounds(boundsOf(vertices, 3));
+}
+
+void Triangle::setVertex(int index, const glm::vec3& position) {
+    setVertices(index, &position, 1);
 }
 
 /**
- * @brief 绘制三角形
- * @param shader 着色器引用，会上传 model 矩阵与 color
+ * @brief 三角形的绘制命令
  */
-void Triangle::draw(Shader& shader) {
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
+DrawCommand Triangle::getDrawCommand() const {
+    return DrawCommand{ VAO, GL_TRIANGLES, 3, 0 };
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    glBindVertexArray(0);
+bool Triangle::getOccluderGeometry(std::vector<glm::vec3>& outVertices, std::vector<uint32_t>& outIndices) const {
+    outVertices.assign(vertices, vertices + 3);
+    outIndices = { 0, 1, 2 };
+    return true;
+}
+
+ShapeMemoryUsage Triangle::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Triangle) - sizeof(Shape);
+    usage.gpuBytes += 3 * m_format.getStride();
+    return usage;
 }
 
 Triangle::~Triangle() {
@@ -274,39 +535,14 @@ Quad::Quad(float x1, float y1, float z1,
     vertices[2] = glm::vec3(x3, y3, z3);
     vertices[3] = glm::vec3(x4, y4, z4);
     
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    m_normal = polygonNormal(vertices, 4);
+    m_format = uploadPrimitive(VAO, VBO, interleave(vertices, 4, m_normal));
+    EBO = uploadQuadIndices(VAO);
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float quadData[24];
-    for (int i = 0; i < 4; i++) {
-        quadData[i*6]     = vertices[i].x;
-        quadData[i*6 + 1] = vertices[i].y;
-        quadData[i*6 + 2] = vertices[i].z;
-        quadData[i*6 + 3] = m_color.r;
-        quadData[i*6 + 4] = m_color.g;
-        quadData[i*6 + 5] = m_color.b;
-    }
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadData), quadData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    setLocalBounds(boundsOf(vertices, 4));
 }
 
-Quad::Quad(Point p1, Point p2, Point p3, Point p4,
+Quad::Quad(const Point& p1, const Point& p2, const Point& p3, const Point& p4,
          const glm::vec3& color) : ColoredShape(color)
 {
     vertices[0] = p1.getPosition();
@@ -314,145 +550,151 @@ Quad::Quad(Point p1, Point p2, Point p3, Point p4,
     vertices[2] = p3.getPosition();
     vertices[3] = p4.getPosition();
     
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    m_normal = polygonNormal(vertices, 4);
+    m_format = uploadPrimitive(VAO, VBO, interleave(vertices, 4, m_normal));
+    EBO = uploadQuadIndices(VAO);
 
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // 准备顶点数据（位置+颜色）
-    float quadData[24];
-    for (int i = 0; i < 4; i++) {
-        quadData[i*6]     = vertices[i].x;
-        quadData[i*6 + 1] = vertices[i].y;
-        quadData[i*6 + 2] = vertices[i].z;
-        quadData[i*6 + 3] = m_color.r;
-        quadData[i*6 + 4] = m_color.g;
-        quadData[i*6 + 5] = m_color.b;
+    setLocalBounds(boundsOf(vertices, 4));
+}
+
+void Quad::setVertices(int first, const glm::vec3* positions, int count) {
+    if (first < 0 || count < 0 || first + count > 4) {
+        throw std::out_of_range("Quad::setVertices: vertex range out of bounds");
     }
-    
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadData), quadData, GL_STATIC_DRAW);
-    
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 解绑VAO
-    glBindVertexArray(0);
+    std::copy(positions, positions + count, vertices + first);
+
+    // 法线不变时只上传改动的顶点，否则四个顶点的法线都要更新
+    glm::vec3 normal = polygonNormal(vertices, 4);
+    if (normal != m_normal) {
+        m_normal = normal;
+        first = 0;
+        count = 4;
+    }
+    updatePrimitive(VAO, VBO, m_format, vertices, 4, m_normal, first, count);
+
+    setLocalBounds(boundsOf(vertices, 4));
+}
+
+void Quad::setVertex(int index, const glm::vec3& position) {
+    setVertices(index, &position, 1);
 }
 
 /**
- * @brief 绘制四边形（使用 GL_QUADS）
- * @param shader 着色器引用，会上传 model 矩阵与 color
+ * @brief 四边形的绘制命令（两个索引三角形）
  */
-void Quad::draw(Shader& shader) {
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
+DrawCommand Quad::getDrawCommand() const {
+    return DrawCommand{ VAO, GL_TRIANGLES, 6, GL_UNSIGNED_SHORT };
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_QUADS, 0, 4);
-    glBindVertexArray(0);
+/**
+ * @brief 四个顶点按多边形顺序组成两个三角形（扇形）
+ */
+bool Quad::getOccluderGeometry(std::vector<glm::vec3>& outVertices, std::vector<uint32_t>& outIndices) const {
+    outVertices.assign(vertices, vertices + 4);
+    outIndices = { 0, 1, 2, 0, 2, 3 };
+    return true;
+}
+
+ShapeMemoryUsage Quad::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Quad) - sizeof(Shape);
+    usage.gpuBytes += 4 * m_format.getStride();
+    usage.gpuBytes += 6 * sizeof(uint16_t);   // 索引缓冲
+    return usage;
 }
 
 Quad::~Quad() {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
 }
 
 // Cube implementation
-Cube::Cube(float size, const glm::vec3& color) : ColoredShape(color) {
+/**
+ * @brief 生成立方体顶点数据（36 个顶点，非索引）
+ * @param size 立方体边长
+ * @return 交错的顶点数据：位置(3) + 法线(3)
+ */
+std::vector<float> Cube::generateVertices(float size) {
     float halfSize = size / 2.0f;
-    
-    // 立方体顶点数据（位置+法线）
-    float cubeVertices[] = {
+
+    // 单位立方体顶点数据（位置方向+法线），位置按 halfSize 缩放
+    static const float unitVertices[] = {
         // 前面
-        -halfSize, -halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize,  halfSize,  0.0f,  0.0f,  1.0f,  m_color.r, m_color.g, m_color.b,
+        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+         1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+        -1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
 
         // 左面
-        -halfSize, -halfSize, -halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize,  halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize,  halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize,  halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize, -halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize, -halfSize, -1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
+        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f, -1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f,  1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
 
         // 后面
-         halfSize, -halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize, -halfSize,  0.0f,  0.0f, -1.0f,  m_color.r, m_color.g, m_color.b,
+         1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+        -1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+        -1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+        -1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+         1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+         1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
 
         // 右面
-         halfSize, -halfSize,  halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize, -halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize, -halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize, -halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize,  halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize,  halfSize,  1.0f,  0.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
+         1.0f, -1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f, -1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f,  1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f,  1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f,  1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f, -1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
 
         // 上面
-        -halfSize,  halfSize,  halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize,  halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize, -halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize,  halfSize, -halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize, -halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize,  halfSize,  halfSize,  0.0f,  1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
+        -1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
+         1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
+         1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+         1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+        -1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+        -1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
 
         // 下面
-        -halfSize, -halfSize, -halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize, -halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize,  halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-         halfSize, -halfSize,  halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize,  halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b,
-        -halfSize, -halfSize, -halfSize,  0.0f, -1.0f,  0.0f,  m_color.r, m_color.g, m_color.b
+        -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
+         1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
+         1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+         1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+        -1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+        -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f
     };
 
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-    // 填充VBO数据
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
-
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    std::vector<float> vertices;
+    vertices.reserve(36 * 6);
+    for (int i = 0; i < 36; ++i) {
+        const float* v = &unitVertices[i * 6];
+        vertices.push_back(v[0] * halfSize);
+        vertices.push_back(v[1] * halfSize);
+        vertices.push_back(v[2] * halfSize);
+        vertices.push_back(v[3]);
+        vertices.push_back(v[4]);
+        vertices.push_back(v[5]);
+    }
+    return vertices;
+}
 
-    // 解绑VAO
-    glBindVertexArray(0);
+Cube::Cube(float size, const glm::vec3& color) : ColoredShape(color) {
+    // 所有立方体共享同一个单位网格，边长折算进模型矩阵
+    m_mesh = MeshCache::getCube();
+    setMeshScale(glm::vec3(size));
+    setLocalBounds(AABB(glm::vec3(-0.5f), glm::vec3(0.5f)));
 }
 
 /**
- * @brief 绘制立方体网格（三角形面）
- * @param shader 着色器引用，会上传 model 矩阵与 color
+ * @brief 立方体网格（三角形面）的绘制命令
  */
-void Cube::draw(Shader& shader) {
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+DrawCommand Cube::getDrawCommand() const {
+    return m_mesh->getDrawCommand();
 }
 
 /**
@@ -467,25 +709,60 @@ void Cube::transpose(const glm::vec3& pose) {
 
 }
 
+/**
+ * @brief 单位立方体的 8 个角与 12 个三角形（尺寸由模型矩阵给出）
+ */
+bool Cube::getOccluderGeometry(std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) const {
+    vertices.clear();
+    for (int i = 0; i < 8; ++i) {
+        vertices.push_back(glm::vec3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f));
+    }
+    indices = {
+        0, 2, 3, 0, 3, 1,   // -Z
+        4, 5, 7, 4, 7, 6,   // +Z
+        0, 1, 5, 0, 5, 4,   // -Y
+        2, 6, 7, 2, 7, 3,   // +Y
+        0, 4, 6, 0, 6, 2,   // -X
+        1, 3, 7, 1, 7, 5    // +X
+    };
+    return true;
+}
+
+ShapeMemoryUsage Cube::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Cube) - sizeof(Shape);
+    usage.sharedCpuBytes += m_mesh->getCpuBytes();
+    usage.sharedGpuBytes += m_mesh->getGpuBytes();
+    return usage;
+}
+
 Cube::~Cube() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
 }
 
 // Sphere implementation
-Sphere::Sphere(float radius, int sectors, int stacks, const glm::vec3& color) 
-    : ColoredShape(color), sectorCount(sectors), stackCount(stacks) {
-    
-    float sectorStep = 2 * M_PI / sectorCount;
-    float stackStep = M_PI / stackCount;
+/**
+ * @brief 生成球体网格（按经纬分段）
+ * @param radius 球半径
+ * @param sectors 经向分段数
+ * @param stacks 纬向分段数
+ * @param vertices 输出：交错的顶点数据，位置(3) + 法线(3)
+ * @param indices 输出：三角形索引
+ */
+void Sphere::generateMesh(float radius, int sectors, int stacks,
+                          std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+
+    float sectorStep = 2 * M_PI / sectors;
+    float stackStep = M_PI / stacks;
     
-    for (int i = 0; i <= stackCount; ++i) {
+    for (int i = 0; i <= stacks; ++i) {
         float stackAngle = M_PI / 2 - i * stackStep;  // 从 pi/2 到 -pi/2
         float xy = radius * cosf(stackAngle);         // r * cos(u)
         float z = radius * sinf(stackAngle);          // r * sin(u)
 
-        // 通过扇区添加 (sectorCount+1) 个顶点
-        for (int j = 0; j <= sectorCount; ++j) {
+        // 通过扇区添加 (sectors+1) 个顶点
+        for (int j = 0; j <= sectors; ++j) {
             float sectorAngle = j * sectorStep;       // 从 0 到 2pi
 
             // 顶点位置 (x, y, z)
@@ -501,20 +778,15 @@ Sphere::Sphere(float radius, int sectors, int stacks, const glm::vec3& color)
             vertices.push_back(normal.x);
             vertices.push_back(normal.y);
             vertices.push_back(normal.z);
-            
-            // 颜色
-            vertices.push_back(m_color.r);
-            vertices.push_back(m_color.g);
-            vertices.push_back(m_color.b);
         }
     }
 
     // 生成索引
-    for (int i = 0; i < stackCount; ++i) {
-        int k1 = i * (sectorCount + 1);     // 当前堆栈的起始索引
-        int k2 = k1 + sectorCount + 1;      // 下一堆栈的起始索引
+    for (int i = 0; i < stacks; ++i) {
+        int k1 = i * (sectors + 1);     // 当前堆栈的起始索引
+        int k2 = k1 + sectors + 1;      // 下一堆栈的起始索引
 
-        for (int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+        for (int j = 0; j < sectors; ++j, ++k1, ++k2) {
             // 2个三角形构成一个四边形
             if (i != 0) {
                 indices.push_back(k1);
@@ -522,55 +794,114 @@ Sphere::Sphere(float radius, int sectors, int stacks, const glm::vec3& color)
                 indices.push_back(k1 + 1);
             }
 
-            if (i != (stackCount - 1)) {
+            if (i != (stacks - 1)) {
                 indices.push_back(k1 + 1);
                 indices.push_back(k2);
                 indices.push_back(k2 + 1);
             }
         }
     }
+}
 
-    // 生成并绑定VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    // 生成并绑定VBO
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
-
-    // 生成并绑定EBO
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // 设置顶点属性指针
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // 解绑VAO
-    glBindVertexArray(0);
+Sphere::Sphere(float radius, int sectors, int stacks, const glm::vec3& color) 
+    : ColoredShape(color), sectorCount(sectors), stackCount(stacks) {
+    
+    // 相同细分的球体共享同一个单位球网格，半径折算进模型矩阵；
+    // 每个细节层级的经纬分段减半（网格同样来自缓存，不会重复生成）
+    for (int level = 0; level < LOD_COUNT; ++level) {
+        m_lodMeshes[level] = getLODMesh(sectorCount, stackCount, level);
+    }
+    setMeshScale(glm::vec3(radius));
+    setLocalBounds(AABB(glm::vec3(-1.0f), glm::vec3(1.0f)));
+}
+
+void Sphere::detachMesh() {
+    if (m_uniqueMesh) return;
+
+    // 写时复制：按最高细节生成一份独立网格，所有层级都指向它（修改后的形状不再切换 LOD）
+    m_uniqueMesh = MeshCache::createUnique(MeshKey{ PrimitiveType::SPHERE, sectorCount, stackCount });
+    for (auto& mesh : m_lodMeshes) mesh = m_uniqueMesh;
+    m_lodLevel = 0;
+}
+
+void Sphere::updateVertices(size_t first, const std::vector<float>& vertices) {
+    detachMesh();
+    if (vertices.empty()) return;
+    m_uniqueMesh->updateVertices(first, vertices);
+
+    // 包围盒只扩大不缩小：保守但正确，避免每次更新都遍历全部顶点
+    AABB bounds = getLocalBounds();
+    for (size_t i = 0; i < vertices.size(); i += 6) {
+        bounds.expand(glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]));
+    }
+    setLocalBounds(bounds);
+}
+
+const std::vector<float>& Sphere::getVertices() const {
+    static const std::vector<float> empty;
+    return m_uniqueMesh ? m_uniqueMesh->getCpuVertices() : empty;
+}
+
+ShapeMemoryUsage Sphere::getMemoryUsage() const {
+    ShapeMemoryUsage usage = Shape::getMemoryUsage();
+    usage.cpuBytes += sizeof(Sphere) - sizeof(Shape);
+    if (m_uniqueMesh) {
+        usage.cpuBytes += m_uniqueMesh->getCpuBytes();
+        usage.gpuBytes += m_uniqueMesh->getGpuBytes();
+        return usage;
+    }
+
+    // 相邻层级可能因分段数下限而指向同一网格
+    for (int level = 0; level < LOD_COUNT; ++level) {
+        if (level > 0 && m_lodMeshes[level] == m_lodMeshes[level - 1]) continue;
+        usage.sharedCpuBytes += m_lodMeshes[level]->getCpuBytes();
+        usage.sharedGpuBytes += m_lodMeshes[level]->getGpuBytes();
+    }
+    return usage;
 }
 
 /**
- * @brief 绘制球体（使用索引绘制）
- * @param shader 着色器引用，会上传 model 矩阵与 color
+ * @brief 球体的绘制命令（使用索引绘制）
  */
-void Sphere::draw(Shader& shader) {
-    glm::mat4 model = getModelMatrix();
-    shader.setMat4("model", model);
+DrawCommand Sphere::getDrawCommand() const {
+    return m_lodMeshes[m_lodLevel]->getDrawCommand();
+}
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, (unsigned int)indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+const float Sphere::LOD_MIN_RADIUS[Sphere::LOD_COUNT] = { 80.0f, 30.0f, 10.0f, 0.0f };
+
+std::shared_ptr<Mesh> Sphere::getLODMesh(int sectors, int stacks, int level) {
+    return MeshCache::getSphere(std::max(6, sectors >> level), std::max(4, stacks >> level));
+}
+
+float Sphere::computeScreenRadius(const glm::mat4& model, const glm::vec3& cameraPosition, float pixelsPerUnit) {
+    // 单位球经过模型矩阵后的半径不超过最大轴向缩放；不用世界包围盒的外接球（最多大 √3 倍）
+    float radius = std::sqrt(std::max({ glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                        glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                        glm::dot(glm::vec3(model[2]), glm::vec3(model[2])) }));
+    float distance = glm::length(glm::vec3(model[3]) - cameraPosition);
+    // 摄像机在球内或强制最高细节
+    if (distance <= radius) return std::numeric_limits<float>::infinity();
+    return radius * pixelsPerUnit / distance;
+}
+
+int Sphere::selectLOD(int currentLevel, float screenRadius) {
+    // 变细需超过上一级阈值的 (1 + h) 倍，变粗需低于本级阈值的 (1 - h) 倍
+    int level = currentLevel;
+    while (level > 0 && screenRadius > LOD_MIN_RADIUS[level - 1] * (1.0f + LOD_HYSTERESIS)) {
+        --level;
+    }
+    while (level < LOD_COUNT - 1 && screenRadius < LOD_MIN_RADIUS[level] * (1.0f - LOD_HYSTERESIS)) {
+        ++level;
+    }
+    return level;
+}
+
+uint32_t Sphere::updateLOD(const glm::vec3& cameraPosition, float pixelsPerUnit) {
+    if (m_uniqueMesh) return 0;
+
+    m_lodLevel = selectLOD(m_lodLevel, computeScreenRadius(getModelMatrix(), cameraPosition, pixelsPerUnit));
+    return (uint32_t)(m_lodMeshes[0]->getIndexCount() - m_lodMeshes[m_lodLevel]->getIndexCount()) / 3;
 }
 
 Sphere::~Sphere() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
 }
\ No newline at end of file
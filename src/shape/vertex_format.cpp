@@ -0,0 +1,146 @@
+#include <shape/vertex_format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+VertexFormat s_defaultFormat;
+}
+
+VertexFormat VertexFormat::getDefault() {
+    return s_defaultFormat;
+}
+
+void VertexFormat::setDefault(const VertexFormat& format) {
+    s_defaultFormat = format;
+}
+
+size_t VertexFormat::getPositionSize() const {
+    switch (position) {
+        case PositionFormat::HALF_FLOAT:
+        case PositionFormat::SNORM16:
+            return 4 * sizeof(uint16_t);    // 补齐到 4 字节对齐
+        default:
+            return 3 * sizeof(float);
+    }
+}
+
+size_t VertexFormat::getNormalSize() const {
+    return normal == NormalFormat::INT_2_10_10_10 ? sizeof(uint32_t) : 3 * sizeof(float);
+}
+
+VertexFormat VertexFormat::forRange(float maxAbs) const {
+    // 不能退化为半精度：单位以外的坐标只有约 3 位有效数字，超过 65504 还会变成无穷
+    VertexFormat format = *this;
+    if (format.position == PositionFormat::SNORM16 && maxAbs > 1.0f) {
+        format.position = PositionFormat::FLOAT32;
+    } else if (format.position == PositionFormat::HALF_FLOAT && !(maxAbs < HALF_MAX)) {
+        format.position = PositionFormat::FLOAT32;
+    }
+    return format;
+}
+
+std::vector<uint8_t> VertexFormat::encode(const std::vector<float>& vertices) const {
+    const size_t vertexCount = vertices.size() / 6;
+    const size_t positionSize = getPositionSize();
+    const size_t stride = getStride();
+
+    std::vector<uint8_t> data(vertexCount * stride, 0);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* src = &vertices[i * 6];
+        uint8_t* dst = &data[i * stride];
+
+        switch (position) {
+            case PositionFormat::HALF_FLOAT: {
+                uint16_t p[4] = { floatToHalf(src[0]), floatToHalf(src[1]), floatToHalf(src[2]), 0 };
+                std::memcpy(dst, p, sizeof(p));
+                break;
+            }
+            case PositionFormat::SNORM16: {
+                int16_t p[4];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = (int16_t)std::lround(std::clamp(src[k], -1.0f, 1.0f) * 32767.0f);
+                }
+                p[3] = 0;
+                std::memcpy(dst, p, sizeof(p));
+                break;
+            }
+            default:
+                std::memcpy(dst, src, 3 * sizeof(float));
+                break;
+        }
+
+        if (normal == NormalFormat::INT_2_10_10_10) {
+            uint32_t n = packSnorm1010102(glm::vec3(src[3], src[4], src[5]));
+            std::memcpy(dst + positionSize, &n, sizeof(n));
+        } else {
+            std::memcpy(dst + positionSize, src + 3, 3 * sizeof(float));
+        }
+    }
+    return data;
+}
+
+void VertexFormat::setupAttributes() const {
+    const GLsizei stride = (GLsizei)getStride();
+
+    switch (position) {
+        case PositionFormat::HALF_FLOAT:
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)0);
+            break;
+        case PositionFormat::SNORM16:
+            glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)0);
+            break;
+        default:
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+            break;
+    }
+    glEnableVertexAttribArray(0);
+
+    void* normalOffset = (void*)getPositionSize();
+    if (normal == NormalFormat::INT_2_10_10_10) {
+        // 打包格式的分量数必须为 4，着色器中的 vec3 只取前三个
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, normalOffset);
+    } else {
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffset);
+    }
+    glEnableVertexAttribArray(1);
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000u);
+    const uint32_t absBits = bits & 0x7FFFFFFFu;
+
+    if (absBits >= 0x7F800000u) {
+        return sign | (absBits > 0x7F800000u ? 0x7E00u : 0x7C00u);  // NaN / 无穷
+    }
+    if (absBits >= 0x477FF000u) {
+        return sign | 0x7C00u;  // >= 65520 舍入后溢出
+    }
+    if (absBits < 0x38800000u) {
+        // 半精度非规格化数（< 2^-14）
+        if (absBits < 0x33000000u) return sign;
+        uint32_t mantissa = (absBits & 0x7FFFFFu) | 0x800000u;
+        uint32_t shift = 126u - (absBits >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t midpoint = 1u << (shift - 1u);
+        if (remainder > midpoint || (remainder == midpoint && (half & 1u))) ++half;
+        return sign | (uint16_t)half;
+    }
+
+    // 规格化数：指数偏移 127 -> 15，尾数就近舍入到偶数（进位会自然进入指数）
+    uint32_t half = (absBits - 0x38000000u) >> 13;
+    uint32_t remainder = absBits & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+    return sign | (uint16_t)half;
+}
+
+uint32_t packSnorm1010102(const glm::vec3& v) {
+    auto quantize = [](float f) {
+        int q = (int)std::lround(std::clamp(f, -1.0f, 1.0f) * 511.0f);
+        return (uint32_t)q & 0x3FFu;
+    };
+    return quantize(v.x) | (quantize(v.y) << 10) | (quantize(v.z) << 20);
+}
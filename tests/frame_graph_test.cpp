@@ -0,0 +1,117 @@
+// 帧图测试：无用通道被剔除、通道按依赖排序执行、生命周期不重叠的瞬态纹理共用物理纹理
+// （使用 gl_stub.cpp 中的 OpenGL 桩，不需要上下文）
+#include <render/frame_graph.hpp>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            g_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+static size_t indexOf(const std::vector<std::string>& order, const std::string& name) {
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (order[i] == name) return i;
+    }
+    return order.size();
+}
+
+/**
+ * @brief 延迟渲染式的一帧：gbuffer -> lighting -> blur -> tonemap，外加一个输出无人读取的 debugviz
+ */
+static void testCullSortAlias(FrameGraph& graph, int width, int height) {
+    std::vector<std::string> order;
+    auto pass = [&order](const char* name) {
+        return [&order, name](const FrameGraph&) { order.push_back(name); };
+    };
+
+    graph.reset();
+    FrameGraph::Resource backbuffer = graph.importBackbuffer("backbuffer", width, height);
+    FrameGraph::Resource albedo = graph.createTexture("albedo", { width, height, GL_RGBA8 });
+    FrameGraph::Resource depth = graph.createTexture("depth", { width, height, GL_DEPTH_COMPONENT24 });
+    FrameGraph::Resource hdr = graph.createTexture("hdr", { width, height, GL_RGBA8 });
+    FrameGraph::Resource blur = graph.createTexture("blur", { width, height, GL_RGBA8 });
+    FrameGraph::Resource debug = graph.createTexture("debug", { width, height, GL_RGBA8 });
+
+    // 故意打乱声明顺序
+    graph.addPass("tonemap", pass("tonemap")).read(blur).read(hdr).write(backbuffer, LoadOp::DONT_CARE);
+    graph.addPass("gbuffer", pass("gbuffer")).write(albedo).write(depth);
+    graph.addPass("debugviz", pass("debugviz")).read(albedo).write(debug);
+    graph.addPass("lighting", pass("lighting")).read(albedo).read(depth).write(hdr);
+    graph.addPass("blur", pass("blur")).read(hdr).write(blur);
+    graph.compile();
+    graph.execute();
+
+    const FrameGraph::Stats& stats = graph.getStats();
+    CHECK(stats.passCount == 5);
+    CHECK(stats.culledPasses == 1);
+
+    // 剔除：debugviz 不执行，其输出不分配纹理
+    CHECK(order.size() == 4);
+    CHECK(indexOf(order, "debugviz") == order.size());
+    CHECK(graph.getTexture(debug) == 0);
+
+    // 排序：生产者先于消费者
+    CHECK(indexOf(order, "gbuffer") < indexOf(order, "lighting"));
+    CHECK(indexOf(order, "lighting") < indexOf(order, "blur"));
+    CHECK(indexOf(order, "blur") < indexOf(order, "tonemap"));
+
+    // 别名：blur 在 albedo 最后一次使用之后才写入，二者格式相同，共用一张物理纹理
+    CHECK(stats.transientTextures == 4);
+    CHECK(stats.physicalTextures == 3);
+    CHECK(stats.physicalBytes < stats.transientBytes);
+    CHECK(graph.getTexture(blur) != 0 && graph.getTexture(blur) == graph.getTexture(albedo));
+    CHECK(graph.getTexture(hdr) != graph.getTexture(albedo));
+    CHECK(graph.getTexture(depth) != graph.getTexture(albedo));
+}
+
+static void testSideEffectKeepsPass() {
+    FrameGraph graph;
+    bool executed = false;
+    FrameGraph::Resource readback = graph.createTexture("readback", { 16, 16, GL_RGBA8 });
+    graph.addPass("readback", [&executed](const FrameGraph&) { executed = true; }).write(readback).setSideEffect();
+    graph.compile();
+    graph.execute();
+    CHECK(executed);
+    CHECK(graph.getStats().culledPasses == 0);
+}
+
+static void testCycleThrows() {
+    FrameGraph graph;
+    FrameGraph::Resource a = graph.createTexture("a", { 16, 16, GL_RGBA8 });
+    FrameGraph::Resource b = graph.createTexture("b", { 16, 16, GL_RGBA8 });
+    graph.addPass("first", [](const FrameGraph&) {}).read(a).write(b).setSideEffect();
+    graph.addPass("second", [](const FrameGraph&) {}).read(b).write(a);
+
+    bool threw = false;
+    try {
+        graph.compile();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    FrameGraph graph;
+    testCullSortAlias(graph, 800, 600);
+    // 同尺寸的下一帧复用上一帧的物理纹理；尺寸改变后旧纹理被释放，数量不累积
+    testCullSortAlias(graph, 800, 600);
+    testCullSortAlias(graph, 1024, 600);
+    testSideEffectKeepsPass();
+    testCycleThrows();
+
+    if (g_failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("frame_graph_test: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+// 无上下文测试用的 OpenGL 桩：生成递增的对象名，其余调用什么也不做。
+// 只覆盖 frame_graph.cpp 与 profiler.cpp 用到的函数；GLEW 下 1.1 之后的函数经由函数指针调用，
+// 因此定义对应的 __glew* 指针（测试以 GLEW_STATIC 编译、不链接 glew32 与 opengl32）
+#include <GL/glew.h>
+
+#ifndef GLAPIENTRY
+#define GLAPIENTRY APIENTRY
+#endif
+
+namespace {
+
+GLuint g_nextName = 1;
+
+void generateNames(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; ++i) names[i] = g_nextName++;
+}
+
+}  // namespace
+
+// OpenGL 1.1：opengl32 直接导出的函数
+#define GL_STUB_CORE(ret, name, params, body) extern "C" ret GLAPIENTRY gl##name params body
+
+#ifdef GLEW_GET_FUN
+#define GL_STUB_EXT(ret, name, pfn, params, body) \
+    static ret GLAPIENTRY stub##name params body  \
+    extern "C" pfn __glew##name = stub##name;
+#else
+#define GL_STUB_EXT(ret, name, pfn, params, body) extern "C" ret GLAPIENTRY gl##name params body
+#endif
+
+GL_STUB_CORE(void, GenTextures, (GLsizei n, GLuint* textures), { generateNames(n, textures); })
+GL_STUB_CORE(void, DeleteTextures, (GLsizei, const GLuint*), {})
+GL_STUB_CORE(void, BindTexture, (GLenum, GLuint), {})
+GL_STUB_CORE(void, TexImage2D, (GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*), {})
+GL_STUB_CORE(void, TexParameteri, (GLenum, GLenum, GLint), {})
+GL_STUB_CORE(void, DrawBuffer, (GLenum), {})
+GL_STUB_CORE(void, ReadBuffer, (GLenum), {})
+GL_STUB_CORE(void, Viewport, (GLint, GLint, GLsizei, GLsizei), {})
+GL_STUB_CORE(void, ClearColor, (GLfloat, GLfloat, GLfloat, GLfloat), {})
+GL_STUB_CORE(void, Clear, (GLbitfield), {})
+GL_STUB_CORE(void, DrawArrays, (GLenum, GLint, GLsizei), {})
+
+GL_STUB_EXT(void, GenFramebuffers, PFNGLGENFRAMEBUFFERSPROC, (GLsizei n, GLuint* framebuffers), { generateNames(n, framebuffers); })
+GL_STUB_EXT(void, DeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC, (GLsizei, const GLuint*), {})
+GL_STUB_EXT(void, BindFramebuffer, PFNGLBINDFRAMEBUFFERPROC, (GLenum, GLuint), {})
+GL_STUB_EXT(void, FramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC, (GLenum, GLenum, GLenum, GLuint, GLint), {})
+GL_STUB_EXT(GLenum, CheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC, (GLenum), { return GL_FRAMEBUFFER_COMPLETE; })
+GL_STUB_EXT(void, DrawBuffers, PFNGLDRAWBUFFERSPROC, (GLsizei, const GLenum*), {})
+GL_STUB_EXT(void, ClearBufferfv, PFNGLCLEARBUFFERFVPROC, (GLenum, GLint, const GLfloat*), {})
+GL_STUB_EXT(void, ClearBufferfi, PFNGLCLEARBUFFERFIPROC, (GLenum, GLint, GLfloat, GLint), {})
+GL_STUB_EXT(void, ActiveTexture, PFNGLACTIVETEXTUREPROC, (GLenum), {})
+GL_STUB_EXT(void, GenVertexArrays, PFNGLGENVERTEXARRAYSPROC, (GLsizei n, GLuint* arrays), { generateNames(n, arrays); })
+GL_STUB_EXT(void, DeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC, (GLsizei, const GLuint*), {})
+GL_STUB_EXT(void, BindVertexArray, PFNGLBINDVERTEXARRAYPROC, (GLuint), {})
+GL_STUB_EXT(void, GenQueries, PFNGLGENQUERIESPROC, (GLsizei n, GLuint* ids), { generateNames(n, ids); })
+GL_STUB_EXT(void, DeleteQueries, PFNGLDELETEQUERIESPROC, (GLsizei, const GLuint*), {})
+GL_STUB_EXT(void, BeginQuery, PFNGLBEGINQUERYPROC, (GLenum, GLuint), {})
+GL_STUB_EXT(void, EndQuery, PFNGLENDQUERYPROC, (GLenum), {})
+GL_STUB_EXT(void, GetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC, (GLuint, GLenum, GLint* params), { *params = 0; })
+GL_STUB_EXT(void, GetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC, (GLuint, GLenum, GLuint64* params), { *params = 0; })
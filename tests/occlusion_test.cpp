@@ -0,0 +1,148 @@
+// 遮挡剔除测试：已知遮挡体挡住其后的包围盒、前方的包围盒保持可见、边按左上填充规则覆盖像素
+#include <scene/occlusion.hpp>
+#include <basic/worker_pool.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+static int g_failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            g_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief z 平面上的矩形（两个三角形，共享一条对角线）
+ */
+static void addRect(OcclusionCuller& culler, float x0, float y0, float x1, float y1, float z) {
+    std::vector<glm::vec3> vertices = { { x0, y0, z }, { x1, y0, z }, { x1, y1, z }, { x0, y1, z } };
+    std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+    culler.addOccluder(vertices, indices, glm::mat4(1.0f));
+}
+
+/**
+ * @brief 像素坐标（深度缓冲中的位置）转 NDC；视图投影为单位矩阵时两者一一对应
+ */
+static float toNdc(float pixel, int size) {
+    return pixel * 2.0f / size - 1.0f;
+}
+
+static float depthAt(const OcclusionCuller& culler, int x, int y) {
+    return culler.getDepth()[(size_t)y * culler.getWidth() + x];
+}
+
+static void testOccludedBox(WorkerPool& pool) {
+    OcclusionCuller culler(256, 128, &pool);
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // 没有遮挡体时一切可见
+    culler.beginFrame(projection * view);
+    culler.rasterize();
+    culler.buildHiZ();
+    CHECK(culler.isVisible(AABB(glm::vec3(-1.0f, -1.0f, -12.0f), glm::vec3(1.0f, 1.0f, -10.0f))));
+
+    // z = -5 处一面 8x8 的墙
+    culler.beginFrame(projection * view);
+    addRect(culler, -4.0f, -4.0f, 4.0f, 4.0f, -5.0f);
+    culler.rasterize();
+    culler.buildHiZ();
+    CHECK(culler.getTriangleCount() == 2);
+
+    // 墙后、投影完全落在墙内的包围盒被遮挡
+    CHECK(!culler.isVisible(AABB(glm::vec3(-1.0f, -1.0f, -12.0f), glm::vec3(1.0f, 1.0f, -10.0f))));
+    // 墙前的包围盒可见
+    CHECK(culler.isVisible(AABB(glm::vec3(-1.0f, -1.0f, -3.0f), glm::vec3(1.0f, 1.0f, -2.0f))));
+    // 墙后但伸出墙边的包围盒可见
+    CHECK(culler.isVisible(AABB(glm::vec3(2.0f, -1.0f, -12.0f), glm::vec3(12.0f, 1.0f, -10.0f))));
+    // 跨过墙面的包围盒可见
+    CHECK(culler.isVisible(AABB(glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f))));
+}
+
+static void testTopLeftFillRule(WorkerPool& pool, unsigned threadCount) {
+    // 64x32 的深度缓冲（两个瓦片），视图投影为单位矩阵
+    OcclusionCuller culler(64, 32, &pool);
+    culler.setThreadCount(threadCount);
+    const int width = culler.getWidth(), height = culler.getHeight();
+    CHECK(width == 64 && height == 32);
+
+    // 两个相邻矩形的边都正好穿过像素中心：左侧矩形覆盖 [0.5, 4.5]，右侧覆盖 [4.5, 8.5]，
+    // 纵向均为 [0.5, 4.5]；右侧矩形更远
+    const float nearZ = -0.6f, farZ = 0.2f;
+    culler.beginFrame(glm::mat4(1.0f));
+    addRect(culler, toNdc(0.5f, width), toNdc(0.5f, height), toNdc(4.5f, width), toNdc(4.5f, height), nearZ);
+    addRect(culler, toNdc(4.5f, width), toNdc(0.5f, height), toNdc(8.5f, width), toNdc(4.5f, height), farZ);
+    culler.rasterize();
+
+    const float nearDepth = nearZ * 0.5f + 0.5f, farDepth = farZ * 0.5f + 0.5f;
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 12; ++x) {
+            // 左边与上边（行号小的一侧）上的像素中心被覆盖，右边与下边上的不被覆盖；
+            // 共享的竖直边只属于右侧矩形，对角线只属于其中一个三角形而不留空隙
+            float expected = 1.0f;
+            if (y < 4 && x < 4) expected = nearDepth;
+            else if (y < 4 && x < 8) expected = farDepth;
+            float depth = depthAt(culler, x, y);
+            if (std::fabs(depth - expected) > 1e-6f) {
+                std::fprintf(stderr, "pixel (%d, %d): depth %f, expected %f\n", x, y, depth, expected);
+                g_failures++;
+            }
+        }
+    }
+
+    // 两种绕序结果相同
+    culler.beginFrame(glm::mat4(1.0f));
+    std::vector<glm::vec3> vertices = { { toNdc(0.5f, width), toNdc(0.5f, height), nearZ },
+                                        { toNdc(4.5f, width), toNdc(0.5f, height), nearZ },
+                                        { toNdc(4.5f, width), toNdc(4.5f, height), nearZ },
+                                        { toNdc(0.5f, width), toNdc(4.5f, height), nearZ } };
+    culler.addOccluder(vertices, { 0, 2, 1, 0, 3, 2 }, glm::mat4(1.0f));
+    culler.rasterize();
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            float expected = (x < 4 && y < 4) ? nearDepth : 1.0f;
+            CHECK(std::fabs(depthAt(culler, x, y) - expected) <= 1e-6f);
+        }
+    }
+}
+
+static void testNonPowerOfTwoHiZ(WorkerPool& pool) {
+    // 160 宽时 mip 宽度为 160 -> 80 -> 40 -> 20 -> 10 -> 5 -> 3 -> 2 -> 1，奇数宽度的最后一列也必须参与取最大值
+    OcclusionCuller culler(160, 32, &pool);
+    const int width = culler.getWidth(), height = culler.getHeight();
+    CHECK(width == 160 && height == 32);
+
+    // 墙覆盖像素列 [0, 128)，右侧 32 列空着
+    culler.beginFrame(glm::mat4(1.0f));
+    addRect(culler, -1.0f, -1.0f, toNdc(128.0f, width), 1.0f, -0.6f);
+    culler.rasterize();
+    culler.buildHiZ();
+
+    for (int level = 1; level < culler.getMipCount(); ++level) {
+        CHECK(culler.getDepth(level).back() == 1.0f);
+    }
+    // 覆盖全屏的包围盒在右侧空白处可见
+    CHECK(culler.isVisible(AABB(glm::vec3(-1.0f, -1.0f, 0.2f), glm::vec3(1.0f, 1.0f, 0.4f))));
+    // 完全在墙后的包围盒被遮挡
+    CHECK(!culler.isVisible(AABB(glm::vec3(-0.9f, -0.9f, 0.2f), glm::vec3(0.5f, 0.9f, 0.4f))));
+}
+
+int main() {
+    WorkerPool pool(4);
+    testOccludedBox(pool);
+    testTopLeftFillRule(pool, 1);
+    testTopLeftFillRule(pool, 0);
+    testNonPowerOfTwoHiZ(pool);
+
+    if (g_failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("occlusion_test: all checks passed\n");
+    return 0;
+}